@@ -235,11 +235,23 @@
 // #  define R61581_ORI          0       /*0, 180*/
 // #  define GC9A01_SPI_BITS        9       /*9 Bit*/
 #  define GC9A01_SPI_BITS        8       // 8 Bit*/
+#  define GC9A01_SPI9_BITBANG    0       // 9 bit only: 1 = bit-bang each word, 0 = pack words for the SPI hardware
 #  define GC9A01_SPI_EXT_CS      0       // 1 = Use CS external to SPI, 0 = CS board managed SPI
 #  define GC9A01_SPI_MODE        2       // Mode 2
 // #  define GC9A01_SPI_BAUD        8000000 // 32Mhz on nrf52840, 8 MHz max on nrf52832
 #  define GC9A01_SPI_BAUD        16000000 // 32Mhz on nrf52840, 8 MHz max on nrf52832
 // #  define GC9A01_SPI_BAUD        32000000 // 32Mhz on nrf52840, 8 MHz max on nrf52832
+#  define GC9A01_FLUSH_ASYNC     1        // 1 = pixel data sent by EasyDMA while LVGL renders, 0 = blocking GC9A01_flush
+#  define GC9A01_FLUSH_ROUND     1        // 1 = only send the pixels inside the round glass, row by row
+#  define GC9A01_RENDER_ROUND    1        // 1 = trim invalidated areas to the round glass before LVGL renders them
+#  define GC9A01_COALESCE        1        // 1 = merge nearby dirty areas when that is cheaper than flushing them apart
+#  define GC9A01_GPU_FILL        1        // 1 = solid fills through gpu_fill_cb, needs LV_USE_GPU in lv_conf.h
+#  define GC9A01_BUS_MONITOR     0        // 1 = decode and count the command stream sent to the panel
+#  define GC9A01_BUF_SINGLE      1        // One strip buffer, render and flush take turns
+#  define GC9A01_BUF_DOUBLE      2        // Two strip buffers, render one while the other is flushed
+#  define GC9A01_BUF_FULL        3        // One full frame buffer (115 KB at 16 bit)
+#  define GC9A01_BUF_MODE        GC9A01_BUF_DOUBLE
+#  define GC9A01_BUF_LINES       10       // Strip height for the single and double modes
 // #  define GC9A01_SPI_BAUD        1000000 // 1Mhz on nrf52840, 8 MHz max on nrf52832
 // #  define GC9A01_SPI_BAUD        200000 // 250kHz on nrf52840, 8 MHz max on nrf52832
 
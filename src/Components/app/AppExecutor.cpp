@@ -0,0 +1,82 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "AppExecutor.h"
+#include "UiCommandQueue.h"
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+using namespace Mytime::Controllers;
+
+static int32_t heap_alloc_count()
+{
+#if MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    return stats.alloc_cnt;
+#else
+    return -1;
+#endif
+}
+
+void AppExecutor::start()
+{
+    _thread.start(mbed::callback(this, &AppExecutor::run));
+}
+
+void AppExecutor::show(App &app)
+{
+    // Only the latest request counts, switches posted before it find nothing to do
+    _posted_us = us_ticker_read();
+    core_util_atomic_store_ptr((void *volatile *)&_next, &app);
+    if (!UiCommandQueue::post(mbed::callback(this, &AppExecutor::switch_to))) {
+        SEGGER_RTT_printf(0, "AppExecutor: queue full, %s not shown\r\n", app.name);
+    }
+}
+
+void AppExecutor::run()
+{
+    _app_queue.dispatch_forever();
+}
+
+void AppExecutor::switch_to()
+{
+    App *app = (App *)core_util_atomic_exchange_ptr((void *volatile *)&_next, nullptr);
+    if (app == nullptr) {
+        return;
+    }
+
+    uint32_t start = us_ticker_read();
+    int32_t allocs = heap_alloc_count();
+
+    if (_current && _current->deinit) {
+        _current->deinit();
+    }
+    _current = app;
+    if (app->init) {
+        app->init();
+    }
+    _switches++;
+
+    if (allocs >= 0) {
+        allocs = heap_alloc_count() - allocs;
+    }
+    SEGGER_RTT_printf(0, "app: %s, switch %u, queued %u us, took %u us, %d allocs\r\n",
+        app->name, _switches, start - _posted_us, us_ticker_read() - start, allocs);
+}
@@ -0,0 +1,97 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __APP_EXECUTOR_H__
+#define __APP_EXECUTOR_H__
+
+#include "mbed.h"
+#include "events/EventQueue.h"
+#include "platform/Callback.h"
+#include "platform/NonCopyable.h"
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Switches between apps, and runs the app timers on one thread that
+         * lives as long as the watch.
+         *
+         * App lifecycles run on the LVGL owner, not on this thread. Apps build
+         * and change LVGL objects, so showing an app posts a command to the
+         * UiCommandQueue and the switch, the current app's deinit and then the
+         * new app's init, runs in the render context with the rest of the UI.
+         *
+         * The thread only dispatches the app event queue, which now holds the
+         * TickTimerService wakeups. Those work out the next boundary and post
+         * the handlers to the UiCommandQueue, so the thread touches no LVGL
+         * and gets a small stack.
+         *
+         * Each switch prints how long the command waited, how long the switch
+         * took and, with MBED_HEAP_STATS_ENABLED, how many heap allocations
+         * it made.
+         */
+        class AppExecutor : private mbed::NonCopyable<AppExecutor>
+        {
+        public:
+            struct App
+            {
+                const char *name;
+                mbed::Callback<void()> init;
+                mbed::Callback<void()> deinit;
+            };
+
+            AppExecutor(events::EventQueue &app_queue) :
+                _app_queue(app_queue),
+                _thread(osPriorityNormal, StackSize, nullptr, "app timers"),
+                _current(nullptr),
+                _next(nullptr),
+                _posted_us(0),
+                _switches(0)
+            {
+            }
+
+            /**
+             * Start the app timer thread.
+             */
+            void start();
+
+            /**
+             * Switch to an app. Safe from interrupts.
+             */
+            void show(App &app);
+
+            /**
+             * The app shown, or nullptr before the first switch.
+             */
+            const App* current() const { return _current; };
+
+        private:
+            // localtime_r() and an RTT print are the deepest calls on the queue
+            static constexpr uint32_t StackSize = 1024;
+
+            void run();
+            void switch_to();
+
+            events::EventQueue &_app_queue;
+            Thread _thread;
+            App *_current;
+            App *volatile _next;
+            volatile uint32_t _posted_us;
+            uint32_t _switches;
+        };
+    }
+}
+
+#endif /* __APP_EXECUTOR_H__ */
@@ -18,6 +18,7 @@
 #include "mbed_mktime.h"
 
 #include "DateTimeController.h"
+#include "Components/watch_face/TickTimerService.h"
 extern "C"{
   #include "SEGGER_RTT.h"
 }
@@ -46,6 +47,7 @@ void DateTimeController::SetTime(uint16_t year, uint8_t month, uint8_t day,
   if (res)
   {
     set_time(conv_result);
+    Mytime::Windows::TickTimerService::time_set();
   }
   
   SEGGER_RTT_printf(0, "%d-%d-%d \n", day, month, year);
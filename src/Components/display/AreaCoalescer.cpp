@@ -0,0 +1,95 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "AreaCoalescer.h"
+
+using namespace Mytime::Controllers;
+
+constexpr uint32_t AreaCoalescer::AreaOverheadPx;
+
+uint8_t AreaCoalescer::_merged_last = 0;
+uint32_t AreaCoalescer::_merged_total = 0;
+
+void AreaCoalescer::start(lv_disp_t *disp)
+{
+    lv_task_set_cb(disp->refr_task, &AreaCoalescer::refr_task_cb);
+}
+
+void AreaCoalescer::refr_task_cb(lv_task_t *task)
+{
+    lv_disp_t *disp = (lv_disp_t *)task->user_data;
+
+    if (disp->inv_p > 1) {
+        _merged_last = coalesce(disp);
+        _merged_total += _merged_last;
+    } else {
+        _merged_last = 0;
+    }
+
+    _lv_disp_refr_task(task);
+}
+
+uint8_t AreaCoalescer::coalesce(lv_disp_t *disp)
+{
+    uint8_t merged = 0;
+    uint16_t count = disp->inv_p;
+
+    // Greedy: keep merging the pair that saves the most until none saves anything
+    while (count > 1) {
+        int32_t best_gain = -1;
+        uint16_t best_a = 0;
+        uint16_t best_b = 0;
+        lv_area_t best_union;
+
+        for (uint16_t a = 0; a < count; a++) {
+            if (disp->inv_area_joined[a]) {
+                continue;
+            }
+            for (uint16_t b = a + 1; b < count; b++) {
+                if (disp->inv_area_joined[b]) {
+                    continue;
+                }
+
+                lv_area_t joined;
+                _lv_area_join(&joined, &disp->inv_areas[a], &disp->inv_areas[b]);
+
+                int32_t gain = (int32_t)(cost(disp->inv_areas[a]) + cost(disp->inv_areas[b])) - (int32_t)cost(joined);
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best_a = a;
+                    best_b = b;
+                    lv_area_copy(&best_union, &joined);
+                }
+            }
+        }
+
+        if (best_gain < 0) {
+            break;
+        }
+
+        // Keep the list packed, the last area takes the merged one's slot
+        lv_area_copy(&disp->inv_areas[best_a], &best_union);
+        count--;
+        lv_area_copy(&disp->inv_areas[best_b], &disp->inv_areas[count]);
+        disp->inv_area_joined[best_b] = disp->inv_area_joined[count];
+        disp->inv_area_joined[count] = 0;
+        merged++;
+    }
+
+    disp->inv_p = count;
+    return merged;
+}
@@ -0,0 +1,78 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __AREA_COALESCER_H__
+#define __AREA_COALESCER_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Merge dirty areas before LVGL refreshes them.
+         *
+         * Every area LVGL refreshes costs a render pass over the object tree and
+         * a CASET/RASET/RAMWR sequence with its D/C toggles on the bus. Two areas
+         * are merged when that fixed cost is more than the extra pixels their
+         * bounding box adds.
+         */
+        class AreaCoalescer
+        {
+        public:
+            /**
+             * Run the merge in front of the display's refresh task.
+             *
+             * Call after lv_disp_drv_register().
+             */
+            static void start(lv_disp_t *disp);
+
+            /**
+             * Merge the pending areas of a display.
+             *
+             * @return the number of areas merged away.
+             */
+            static uint8_t coalesce(lv_disp_t *disp);
+
+            /**
+             * Areas merged away in the last refresh.
+             */
+            static uint8_t merged_last() { return _merged_last; };
+
+            /**
+             * Areas merged away since start().
+             */
+            static uint32_t merged_total() { return _merged_total; };
+
+        private:
+            // Fixed cost of one flushed area expressed in pixels
+            static constexpr uint32_t AreaOverheadPx = 48;
+
+            static uint32_t cost(const lv_area_t &area)
+            {
+                return AreaOverheadPx + lv_area_get_size(&area);
+            };
+
+            static void refr_task_cb(lv_task_t *task);
+
+            static uint8_t _merged_last;
+            static uint32_t _merged_total;
+        };
+    }
+}
+
+#endif /* __AREA_COALESCER_H__ */
@@ -0,0 +1,287 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "lv_drv_conf.h"
+#include "common.h"
+#include "DisplayFlush.h"
+#include "RoundPanel.h"
+#include "FillAccelerator.h"
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+using namespace Mytime::Controllers;
+
+constexpr uint32_t DisplayFlush::MaxTransferSize;
+constexpr uint8_t DisplayFlush::MaxSegments;
+constexpr uint16_t DisplayFlush::SpanMinSaving;
+constexpr uint32_t DisplayFlush::PatternSize;
+
+DisplayFlush *DisplayFlush::_instance = nullptr;
+lv_color_t DisplayFlush::_pattern[PatternSize];
+
+void DisplayFlush::start(lv_disp_drv_t &drv)
+{
+    _instance = this;
+    _drv = &drv;
+    _round = GC9A01_FLUSH_ROUND;
+    drv.flush_cb = &DisplayFlush::flush_cb;
+    drv.wait_cb = &DisplayFlush::wait_cb;
+}
+
+void DisplayFlush::write_command(uint8_t cmd, const uint8_t *params, uint8_t len)
+{
+    // Let the pixels already queued reach the panel first
+    while (_transfer_active || _run_valid) {
+        service();
+    }
+
+    send_command(cmd, params, len);
+}
+
+void DisplayFlush::flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    DisplayFlush *self = _instance;
+
+    // A single colour flush releases its buffer early, so it may still be
+    // going out when LVGL hands over the next one
+    while (self->_transfer_active || self->_run_valid) {
+        self->service();
+    }
+
+    self->_drv = drv;
+    self->_segment_count = 0;
+    self->_segment_next = 0;
+    self->_segment_row = 0;
+
+    uint32_t px = lv_area_get_size(area);
+    lv_color_t color;
+    bool solid = FillAccelerator::take_solid(color_p, px, color);
+
+    if (solid) {
+        FillAccelerator::fill(_pattern, LV_MATH_MIN(px, PatternSize), color);
+        self->add_segment(*area, (const uint8_t *)_pattern, px * sizeof(lv_color_t), self->_round, true);
+    } else {
+        self->add_segment(*area, (const uint8_t *)color_p, px * sizeof(lv_color_t), self->_round, false);
+    }
+
+    self->_run_offset = 0;
+    self->_run_valid = self->next_run();
+    self->_ready_on_complete = !solid;
+    if (solid || !self->_run_valid) {
+        // Nothing left to read from the draw buffer, or the whole area is
+        // outside the glass
+        lv_disp_flush_ready(drv);
+    }
+    self->service();
+}
+
+void DisplayFlush::wait_cb(lv_disp_drv_t *drv)
+{
+    // LVGL spins here on the event queue thread, so the queued service call
+    // cannot run until it returns. Move the bus along from here instead.
+    _instance->service();
+}
+
+void DisplayFlush::transfer_complete()
+{
+    DisplayFlush *self = _instance;
+    self->_transfer_active = false;
+
+    if (self->_last_transfer) {
+        // Last byte of the flush is out, LVGL may reuse the buffer
+        self->_last_transfer = false;
+        if (self->_ready_on_complete) {
+            lv_disp_flush_ready(self->_drv);
+        }
+    } else if (!self->_in_service && !self->_service_pending) {
+        self->_service_pending = true;
+        self->_event_queue.call(self, &DisplayFlush::service);
+    }
+}
+
+void DisplayFlush::add_segment(const lv_area_t &area, const uint8_t *data, uint32_t len, bool round, bool solid)
+{
+    if (_segment_count >= MaxSegments) {
+        SEGGER_RTT_printf(0, "DisplayFlush: segment list full\r\n");
+        return;
+    }
+
+    Segment &seg = _segments[_segment_count];
+    lv_area_copy(&seg.area, &area);
+    seg.data = data;
+    seg.len = len;
+    seg.round = round;
+    seg.solid = solid;
+    _segment_count++;
+}
+
+bool DisplayFlush::next_run()
+{
+    while (_segment_next < _segment_count) {
+        const Segment &seg = _segments[_segment_next];
+
+        if (seg.round) {
+            if (next_round_run(seg)) {
+                return true;
+            }
+        } else if (_segment_row == 0) {
+            lv_area_copy(&_run.area, &seg.area);
+            _run.data = seg.data;
+            _run.len = seg.len;
+            _run.solid = seg.solid;
+            _segment_row = 1;
+            return true;
+        }
+
+        _segment_next++;
+        _segment_row = 0;
+    }
+
+    return false;
+}
+
+bool DisplayFlush::next_round_run(const Segment &seg)
+{
+    const lv_coord_t w = lv_area_get_width(&seg.area);
+    lv_coord_t y = seg.area.y1 + _segment_row;
+
+    while (y <= seg.area.y2) {
+        lv_coord_t xs = LV_MATH_MAX(seg.area.x1, RoundPanel::row_start(y));
+        lv_coord_t xe = LV_MATH_MIN(seg.area.x2, RoundPanel::row_end(y));
+
+        if (xs > xe) {
+            // Row is completely behind the bezel
+            _bytes_skipped += w * sizeof(lv_color_t);
+            y++;
+            continue;
+        }
+
+        uint32_t saving = (w - (xe - xs + 1)) * sizeof(lv_color_t);
+        if (saving >= SpanMinSaving) {
+            // Worth a window of its own
+            lv_area_set(&_run.area, xs, y, xe, y);
+            _run.data = seg.solid ? seg.data : seg.data + ((y - seg.area.y1) * w + (xs - seg.area.x1)) * sizeof(lv_color_t);
+            _run.len = (xe - xs + 1) * sizeof(lv_color_t);
+            _run.solid = seg.solid;
+            _bytes_skipped += saving;
+            _segment_row = y + 1 - seg.area.y1;
+            return true;
+        }
+
+        // Send this row and the following cheap ones as one full width block,
+        // they are contiguous in the draw buffer
+        lv_coord_t y_first = y;
+        do {
+            y++;
+            if (y > seg.area.y2) {
+                break;
+            }
+            xs = LV_MATH_MAX(seg.area.x1, RoundPanel::row_start(y));
+            xe = LV_MATH_MIN(seg.area.x2, RoundPanel::row_end(y));
+        } while (xs <= xe && (w - (xe - xs + 1)) * sizeof(lv_color_t) < SpanMinSaving);
+
+        lv_area_set(&_run.area, seg.area.x1, y_first, seg.area.x2, y - 1);
+        _run.data = seg.solid ? seg.data : seg.data + (y_first - seg.area.y1) * w * sizeof(lv_color_t);
+        _run.len = (y - y_first) * w * sizeof(lv_color_t);
+        _run.solid = seg.solid;
+        _segment_row = y - seg.area.y1;
+        return true;
+    }
+
+    return false;
+}
+
+void DisplayFlush::service()
+{
+    _service_pending = false;
+    if (_in_service) {
+        return;
+    }
+
+    _in_service = true;
+    for (;;) {
+        pump();
+
+        // A transfer completing since pump() looked saw _in_service still set
+        // and posted nothing, so look again with its interrupt held off
+        CriticalSectionLock lock;
+        if (_transfer_active || !_run_valid) {
+            _in_service = false;
+            return;
+        }
+    }
+}
+
+void DisplayFlush::pump()
+{
+    while (!_transfer_active && _run_valid) {
+        if (_run_offset == 0) {
+            set_window(_run.area);
+        } else {
+            // Keep filling the same window after the previous chunk
+            send_command(MemoryWriteContinue, nullptr, 0);
+        }
+
+        // A solid run sends the same pattern over and over
+        uint32_t max = _run.solid ? PatternSize * sizeof(lv_color_t) : MaxTransferSize;
+        uint32_t len = _run.len - _run_offset;
+        if (len > max) {
+            len = max;
+        }
+        const uint8_t *data = _run.solid ? _run.data : _run.data + _run_offset;
+
+        _run_offset += len;
+        if (_run_offset >= _run.len) {
+            _run_offset = 0;
+            _run_valid = next_run();
+        }
+        _bytes_sent += len;
+
+        _last_transfer = !_run_valid;
+        _transfer_active = true;
+        pin_cmd_set(1);
+        spi_wr_mem_async((char *)data, len, &DisplayFlush::transfer_complete);
+    }
+}
+
+void DisplayFlush::set_window(const lv_area_t &area)
+{
+    uint16_t x1 = area.x1 + GC9A01_XSTART;
+    uint16_t x2 = area.x2 + GC9A01_XSTART;
+    uint16_t y1 = area.y1 + GC9A01_YSTART;
+    uint16_t y2 = area.y2 + GC9A01_YSTART;
+
+    uint8_t columns[4] = {(uint8_t)(x1 >> 8), (uint8_t)x1, (uint8_t)(x2 >> 8), (uint8_t)x2};
+    uint8_t rows[4] = {(uint8_t)(y1 >> 8), (uint8_t)y1, (uint8_t)(y2 >> 8), (uint8_t)y2};
+
+    send_command(ColumnAddressSet, columns, sizeof(columns));
+    send_command(RowAddressSet, rows, sizeof(rows));
+    send_command(MemoryWrite, nullptr, 0);
+}
+
+void DisplayFlush::send_command(uint8_t cmd, const uint8_t *params, uint8_t len)
+{
+    pin_cmd_set(0);
+    spi_wr(cmd);
+
+    if (len) {
+        pin_cmd_set(1);
+        spi_wr_mem((char *)params, len);
+    }
+}
@@ -0,0 +1,205 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DISPLAY_FLUSH_H__
+#define __DISPLAY_FLUSH_H__
+
+#include "mbed.h"
+#include "events/EventQueue.h"
+#include "platform/NonCopyable.h"
+
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Non-blocking flush of LVGL draw buffers to the GC9A01.
+         *
+         * The column/row window and RAMWR command are written in thread context,
+         * the pixel data is clocked out by EasyDMA in the background and
+         * lv_disp_flush_ready() is called from the transfer complete interrupt, so
+         * LVGL can render the next strip while the previous one is on the bus.
+         *
+         * With GC9A01_FLUSH_ROUND each area is cut into per-row spans so the
+         * corners hidden by the round glass are never sent.
+         *
+         * A draw buffer holding a single colour is sent from a small pattern
+         * buffer instead, and released to LVGL before the transfer starts.
+         */
+        class DisplayFlush : private mbed::NonCopyable<DisplayFlush>
+        {
+        public:
+            enum Commands : uint8_t {
+                ColumnAddressSet = 0x2A,
+                RowAddressSet = 0x2B,
+                MemoryWrite = 0x2C,
+                MemoryWriteContinue = 0x3C
+            };
+
+            DisplayFlush(events::EventQueue &event_queue) :
+                _event_queue(event_queue),
+                _drv(nullptr),
+                _round(false),
+                _segment_count(0),
+                _segment_next(0),
+                _segment_row(0),
+                _run(),
+                _run_valid(false),
+                _run_offset(0),
+                _transfer_active(false),
+                _last_transfer(false),
+                _ready_on_complete(false),
+                _service_pending(false),
+                _in_service(false),
+                _bytes_sent(0),
+                _bytes_skipped(0)
+            {
+            }
+
+            /**
+             * Hook the flush and wait callbacks into the display driver.
+             *
+             * Call before lv_disp_drv_register(), after RoundPanel::init().
+             */
+            void start(lv_disp_drv_t &drv);
+
+            /**
+             * Write a command and its parameters to the panel.
+             *
+             * Waits for any background pixel transfer to finish first.
+             */
+            void write_command(uint8_t cmd, const uint8_t *params, uint8_t len);
+
+            /**
+             * Pixel bytes written to the panel since start().
+             */
+            uint32_t bytes_sent() const { return _bytes_sent; };
+
+            /**
+             * Pixel bytes dropped because they fall outside the round glass.
+             */
+            uint32_t bytes_skipped() const { return _bytes_skipped; };
+
+            /**
+             * Send only the pixels inside the round glass, or whole rows.
+             *
+             * start() sets it from GC9A01_FLUSH_ROUND. Takes effect from the
+             * next flush.
+             */
+            void set_round(bool round) { _round = round; };
+            bool round() const { return _round; };
+
+        private:
+            // EasyDMA MAXCNT is 16 bits, keep each transfer well under it
+            static constexpr uint32_t MaxTransferSize = 32768;
+            static constexpr uint8_t MaxSegments = 8;
+            // A row gets its own window only when that skips more bytes than
+            // the CASET/RASET/RAMWR sequence and transfer setup cost
+            static constexpr uint16_t SpanMinSaving = 24;
+            // Pixels in the repeated pattern for single colour flushes
+            static constexpr uint32_t PatternSize = LV_HOR_RES_MAX * 4;
+
+            /**
+             * Pixels for one flush area, in LVGL buffer order.
+             *
+             * A round segment is sent as per-row spans clipped to the visible
+             * disc, a plain one as a single window. A solid segment repeats the
+             * pattern buffer instead of walking through data.
+             */
+            struct Segment {
+                lv_area_t area;
+                const uint8_t *data;
+                uint32_t len;
+                bool round;
+                bool solid;
+            };
+
+            /**
+             * One rectangular window of contiguous pixel bytes.
+             */
+            struct Run {
+                lv_area_t area;
+                const uint8_t *data;
+                uint32_t len;
+                bool solid;
+            };
+
+            static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+            static void wait_cb(lv_disp_drv_t *drv);
+            static void transfer_complete();
+
+            /**
+             * Queue a segment for the current flush.
+             */
+            void add_segment(const lv_area_t &area, const uint8_t *data, uint32_t len, bool round, bool solid);
+
+            /**
+             * Work out the next run from the queued segments.
+             *
+             * @return false when the flush has nothing left to send.
+             */
+            bool next_run();
+            bool next_round_run(const Segment &seg);
+
+            /**
+             * Start the next queued transfer if the bus is free.
+             *
+             * Runs in thread context, either from the event queue or from LVGL
+             * while it waits for a draw buffer to be released.
+             */
+            void service();
+
+            /**
+             * Start transfers until the bus is busy or the flush is done.
+             */
+            void pump();
+
+            void set_window(const lv_area_t &area);
+            void send_command(uint8_t cmd, const uint8_t *params, uint8_t len);
+
+            events::EventQueue &_event_queue;
+            lv_disp_drv_t *_drv;
+            bool _round;
+
+            Segment _segments[MaxSegments];
+            uint8_t _segment_count;
+            uint8_t _segment_next;
+            lv_coord_t _segment_row;
+
+            Run _run;
+            bool _run_valid;
+            uint32_t _run_offset;
+
+            volatile bool _transfer_active;
+            volatile bool _last_transfer;
+            bool _ready_on_complete;
+            volatile bool _service_pending;
+            bool _in_service;
+
+            uint32_t _bytes_sent;
+            uint32_t _bytes_skipped;
+
+            static lv_color_t _pattern[PatternSize];
+            static DisplayFlush *_instance;
+        };
+    }
+}
+
+#endif /* __DISPLAY_FLUSH_H__ */
@@ -0,0 +1,191 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "DisplayPowerManager.h"
+#include "RenderScheduler.h"
+#include "ScrollTransition.h"
+
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+using namespace Mytime::Controllers;
+
+constexpr uint32_t DisplayPowerManager::DimTimeout;
+constexpr uint32_t DisplayPowerManager::OffTimeout;
+constexpr uint32_t DisplayPowerManager::SleepOutDelay;
+
+// Backlight level for each state, 0 is off and 3 is full
+static const uint8_t backlight_levels[DisplayPowerManager::StateCount] = {3, 1, 1, 0};
+
+void DisplayPowerManager::start()
+{
+    _state = Active;
+    _state_since = osKernelGetTickCount();
+    set_backlight(backlight_levels[Active]);
+    arm_timeout();
+}
+
+void DisplayPowerManager::set_state(State state)
+{
+    if (state == _state) {
+        return;
+    }
+
+    uint32_t now = osKernelGetTickCount();
+    _time_in_state[_state] += now - _state_since;
+    _state_since = now;
+    _state = state;
+
+    if (state == Off) {
+        // A wake still waiting out SLPOUT puts the panel back to sleep itself
+        if (!_wake_id && !_panel_asleep) {
+            sleep_panel();
+        }
+        return;
+    }
+
+    if (_panel_asleep) {
+        if (!_wake_id) {
+            _display_flush.write_command(SleepOut, nullptr, 0);
+            _wake_id = _event_queue.call_in(SleepOutDelay, this, &DisplayPowerManager::wake_complete);
+        }
+        return;
+    }
+
+    set_idle(state == AlwaysOn);
+    set_backlight(backlight_levels[state]);
+}
+
+void DisplayPowerManager::user_activity()
+{
+    _event_queue.call(this, &DisplayPowerManager::wake);
+}
+
+void DisplayPowerManager::set_always_on(bool enable)
+{
+    _always_on = enable;
+
+    if (enable && _state == Off) {
+        set_state(AlwaysOn);
+    } else if (!enable && _state == AlwaysOn) {
+        set_state(Off);
+    }
+}
+
+uint32_t DisplayPowerManager::time_in_state(State state) const
+{
+    uint32_t time = _time_in_state[state];
+    if (state == _state) {
+        time += osKernelGetTickCount() - _state_since;
+    }
+    return time;
+}
+
+void DisplayPowerManager::report() const
+{
+    SEGGER_RTT_printf(0, "display: active=%u dimmed=%u aod=%u off=%u ms\r\n",
+        time_in_state(Active), time_in_state(Dimmed), time_in_state(AlwaysOn), time_in_state(Off));
+}
+
+void DisplayPowerManager::wake()
+{
+    set_state(Active);
+    arm_timeout();
+}
+
+void DisplayPowerManager::timeout()
+{
+    _timeout_id = 0;
+
+    if (_state == Active) {
+        set_state(Dimmed);
+        arm_timeout();
+    } else if (_state == Dimmed) {
+        set_state(_always_on ? AlwaysOn : Off);
+    }
+}
+
+void DisplayPowerManager::wake_complete()
+{
+    _wake_id = 0;
+
+    if (_state == Off) {
+        // Turned off again while waking up, SLPIN is allowed now
+        _display_flush.write_command(SleepIn, nullptr, 0);
+        return;
+    }
+
+    _display_flush.write_command(DisplayOn, nullptr, 0);
+    _panel_asleep = false;
+    set_idle(_state == AlwaysOn);
+
+    // Redraw everything once, then carry on as before
+    lv_obj_invalidate(lv_scr_act());
+    RenderScheduler::resume();
+
+    set_backlight(backlight_levels[_state]);
+}
+
+void DisplayPowerManager::arm_timeout()
+{
+    if (_timeout_id) {
+        _event_queue.cancel(_timeout_id);
+        _timeout_id = 0;
+    }
+
+    if (_state == Active) {
+        _timeout_id = _event_queue.call_in(DimTimeout, this, &DisplayPowerManager::timeout);
+    } else if (_state == Dimmed) {
+        _timeout_id = _event_queue.call_in(OffTimeout, this, &DisplayPowerManager::timeout);
+    }
+}
+
+void DisplayPowerManager::set_backlight(uint8_t level)
+{
+    // The backlight lines are active low and add up, level 2 drives the
+    // first two
+    _light_level1 = (level >= 1) ? 0 : 1;
+    _light_level2 = (level >= 2) ? 0 : 1;
+    _light_level3 = (level >= 3) ? 0 : 1;
+}
+
+void DisplayPowerManager::set_idle(bool idle)
+{
+    if (idle == _panel_idle) {
+        return;
+    }
+
+    _display_flush.write_command(idle ? IdleModeOn : IdleModeOff, nullptr, 0);
+    _panel_idle = idle;
+}
+
+void DisplayPowerManager::sleep_panel()
+{
+    set_backlight(0);
+
+    // No more lv_task_handler() runs, so nothing new reaches the flush.
+    // write_command() lets the pixels already queued go out first.
+    RenderScheduler::suspend();
+    // Leave no slide half way, the scroll start must be back at row 0
+    ScrollTransition::stop();
+    _display_flush.write_command(DisplayOff, nullptr, 0);
+    _display_flush.write_command(SleepIn, nullptr, 0);
+    _panel_asleep = true;
+}
@@ -0,0 +1,154 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DISPLAY_POWER_MANAGER_H__
+#define __DISPLAY_POWER_MANAGER_H__
+
+#include "mbed.h"
+#include "events/EventQueue.h"
+#include "platform/NonCopyable.h"
+
+#include "DisplayFlush.h"
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Backlight and panel power states.
+         *
+         * Active and Dimmed only differ in backlight level. Always-On keeps
+         * drawing with the backlight at its lowest and the GC9A01 in idle mode
+         * (8 colours). Off turns the backlight off, puts the panel to sleep and
+         * stops LVGL, so neither the CPU nor the SPI bus do any display work.
+         *
+         * With no user activity the display goes Active -> Dimmed -> Off, or to
+         * Always-On instead of Off when that is enabled. Leaving Off redraws the
+         * whole screen once, the panel RAM is not trusted after sleep.
+         */
+        class DisplayPowerManager : private mbed::NonCopyable<DisplayPowerManager>
+        {
+        public:
+            enum State : uint8_t {
+                Active = 0,
+                Dimmed,
+                AlwaysOn,
+                Off,
+                StateCount
+            };
+
+            enum Commands : uint8_t {
+                SleepIn = 0x10,
+                SleepOut = 0x11,
+                DisplayOff = 0x28,
+                DisplayOn = 0x29,
+                IdleModeOff = 0x38,
+                IdleModeOn = 0x39
+            };
+
+            DisplayPowerManager(events::EventQueue &event_queue, DisplayFlush &display_flush,
+                DigitalOut &light_level1, DigitalOut &light_level2, DigitalOut &light_level3) :
+                _event_queue(event_queue),
+                _display_flush(display_flush),
+                _light_level1(light_level1),
+                _light_level2(light_level2),
+                _light_level3(light_level3),
+                _state(Active),
+                _panel_asleep(false),
+                _panel_idle(false),
+                _always_on(false),
+                _timeout_id(0),
+                _wake_id(0),
+                _state_since(0),
+                _time_in_state()
+            {
+            }
+
+            /**
+             * Start in Active and arm the inactivity timeout.
+             *
+             * Call after the panel is initialised and LVGL is running.
+             */
+            void start();
+
+            /**
+             * Move to a state straight away.
+             *
+             * Thread context only, the panel commands block on the SPI bus.
+             */
+            void set_state(State state);
+
+            State state() const { return _state; };
+
+            /**
+             * Report a button press, notification or other user activity.
+             *
+             * Returns the display to Active and restarts the timeout. Safe from
+             * interrupts.
+             */
+            void user_activity();
+
+            /**
+             * Use Always-On instead of Off once the display times out.
+             */
+            void set_always_on(bool enable);
+
+            /**
+             * Milliseconds spent in a state since start(), including the
+             * current stretch.
+             */
+            uint32_t time_in_state(State state) const;
+
+            /**
+             * Print the time spent in each state.
+             */
+            void report() const;
+
+        private:
+            // Inactivity before dimming, and after that before turning off
+            static constexpr uint32_t DimTimeout = 10000;
+            static constexpr uint32_t OffTimeout = 5000;
+            // GC9A01 needs 120 ms after SLPOUT before it accepts SLPIN or
+            // shows a picture again
+            static constexpr uint32_t SleepOutDelay = 120;
+
+            void wake();
+            void timeout();
+            void wake_complete();
+
+            void arm_timeout();
+            void set_backlight(uint8_t level);
+            void set_idle(bool idle);
+            void sleep_panel();
+
+            events::EventQueue &_event_queue;
+            DisplayFlush &_display_flush;
+            DigitalOut &_light_level1;
+            DigitalOut &_light_level2;
+            DigitalOut &_light_level3;
+
+            State _state;
+            bool _panel_asleep;
+            bool _panel_idle;
+            bool _always_on;
+            int _timeout_id;
+            int _wake_id;
+
+            uint32_t _state_since;
+            uint32_t _time_in_state[StateCount];
+        };
+    }
+}
+
+#endif /* __DISPLAY_POWER_MANAGER_H__ */
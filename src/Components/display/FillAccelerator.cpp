@@ -0,0 +1,106 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "FillAccelerator.h"
+
+using namespace Mytime::Controllers;
+
+bool FillAccelerator::_solid = false;
+lv_color_t FillAccelerator::_solid_color;
+uint32_t FillAccelerator::_fills = 0;
+uint32_t FillAccelerator::_solid_flushes = 0;
+
+void FillAccelerator::gpu_fill_cb(lv_disp_drv_t *drv, lv_color_t *dest_buf, lv_coord_t dest_width,
+    const lv_area_t *fill_area, lv_color_t color)
+{
+    lv_coord_t w = lv_area_get_width(fill_area);
+    lv_coord_t h = lv_area_get_height(fill_area);
+    lv_color_t *dest = dest_buf + fill_area->y1 * dest_width + fill_area->x1;
+
+    _fills++;
+
+    if (w == dest_width) {
+        // Rows are back to back, one run does the lot
+        fill(dest, (uint32_t)w * h, color);
+    } else {
+        for (lv_coord_t y = 0; y < h; y++) {
+            fill(dest, w, color);
+            dest += dest_width;
+        }
+    }
+
+    const lv_area_t *buf_area = &drv->buffer->area;
+    if (fill_area->x1 == 0 && fill_area->y1 == 0 &&
+        w == lv_area_get_width(buf_area) && h == lv_area_get_height(buf_area)) {
+        _solid = true;
+        _solid_color = color;
+    }
+}
+
+void FillAccelerator::fill(lv_color_t *dest, uint32_t px, lv_color_t color)
+{
+#if LV_COLOR_DEPTH == 16
+    // Get onto a word boundary, then store two pixels at a time
+    if (((uintptr_t)dest & 2) && px) {
+        *dest++ = color;
+        px--;
+    }
+
+    uint32_t word = color.full | ((uint32_t)color.full << 16);
+    uint32_t *dest32 = (uint32_t *)dest;
+    uint32_t words = px / 2;
+
+    while (words >= 4) {
+        dest32[0] = word;
+        dest32[1] = word;
+        dest32[2] = word;
+        dest32[3] = word;
+        dest32 += 4;
+        words -= 4;
+    }
+    while (words--) {
+        *dest32++ = word;
+    }
+
+    if (px & 1) {
+        *(lv_color_t *)dest32 = color;
+    }
+#else
+    while (px--) {
+        *dest++ = color;
+    }
+#endif
+}
+
+bool FillAccelerator::take_solid(const lv_color_t *buf, uint32_t px, lv_color_t &color)
+{
+    if (!_solid) {
+        return false;
+    }
+    _solid = false;
+
+    // Something may have been drawn over the fill, a mismatch ends this early
+    for (uint32_t i = 0; i < px; i++) {
+        if (buf[i].full != _solid_color.full) {
+            return false;
+        }
+    }
+
+    color = _solid_color;
+    _solid_flushes++;
+    return true;
+}
@@ -0,0 +1,71 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FILL_ACCELERATOR_H__
+#define __FILL_ACCELERATOR_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Solid colour fills for LVGL's gpu_fill_cb.
+         *
+         * Fills are written two pixels per word store instead of LVGL's pixel
+         * loop. A fill that covers the whole draw buffer is remembered so the
+         * flush can send it from a small pattern buffer instead of the pixels.
+         */
+        class FillAccelerator
+        {
+        public:
+            static void gpu_fill_cb(lv_disp_drv_t *drv, lv_color_t *dest_buf, lv_coord_t dest_width,
+                const lv_area_t *fill_area, lv_color_t color);
+
+            /**
+             * Write px pixels of one colour starting at dest.
+             */
+            static void fill(lv_color_t *dest, uint32_t px, lv_color_t color);
+
+            /**
+             * Check whether the draw buffer about to be flushed is one colour.
+             *
+             * Only true when a fill covered the whole buffer and nothing drawn
+             * after it changed a pixel. Clears the remembered fill.
+             */
+            static bool take_solid(const lv_color_t *buf, uint32_t px, lv_color_t &color);
+
+            /**
+             * Fills handled since start up.
+             */
+            static uint32_t fills() { return _fills; };
+
+            /**
+             * Flushes sent as a repeated colour instead of pixels.
+             */
+            static uint32_t solid_flushes() { return _solid_flushes; };
+
+        private:
+            static bool _solid;
+            static lv_color_t _solid_color;
+            static uint32_t _fills;
+            static uint32_t _solid_flushes;
+        };
+    }
+}
+
+#endif /* __FILL_ACCELERATOR_H__ */
@@ -0,0 +1,130 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include "PanelMonitor.h"
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+using namespace Mytime::Controllers;
+
+PanelMonitor::Stats PanelMonitor::_stats;
+uint8_t PanelMonitor::_cmd = 0;
+uint8_t PanelMonitor::_param_index = 0;
+uint8_t PanelMonitor::_params[4];
+uint16_t PanelMonitor::_x1 = 0;
+uint16_t PanelMonitor::_x2 = 0;
+uint16_t PanelMonitor::_y1 = 0;
+uint16_t PanelMonitor::_y2 = 0;
+bool PanelMonitor::_column_set = false;
+uint32_t PanelMonitor::_written = 0;
+uint8_t PanelMonitor::_madctl = 0;
+uint8_t PanelMonitor::_colmod = 0x66; // 18 bit after reset
+
+void PanelMonitor::command(uint8_t cmd)
+{
+    _stats.commands++;
+    _cmd = cmd;
+    _param_index = 0;
+
+    if (cmd == MemoryWrite) {
+        // RAMWR restarts at the top left of the window, RAMWRC carries on
+        _written = 0;
+        _stats.memory_writes++;
+    } else if (cmd == MemoryWriteContinue) {
+        _stats.memory_writes++;
+    }
+}
+
+void PanelMonitor::data(const uint8_t *buf, uint32_t len)
+{
+    if (_cmd == MemoryWrite || _cmd == MemoryWriteContinue) {
+        uint32_t limit = window_bytes();
+        _stats.pixel_bytes += len;
+        _written += len;
+        if (_written > limit) {
+            _stats.overruns += (_written - limit) / ((_colmod & 0x07) == 0x05 ? 2 : 3);
+            _written = limit;
+        }
+        return;
+    }
+
+    _stats.param_bytes += len;
+    for (uint32_t i = 0; i < len; i++) {
+        if (_param_index < sizeof(_params)) {
+            _params[_param_index] = buf[i];
+        }
+        _param_index++;
+
+        switch (_cmd) {
+            case ColumnAddressSet:
+                if (_param_index == 4) {
+                    _x1 = (_params[0] << 8) | _params[1];
+                    _x2 = (_params[2] << 8) | _params[3];
+                    _column_set = true;
+                }
+                break;
+            case RowAddressSet:
+                if (_param_index == 4) {
+                    _y1 = (_params[0] << 8) | _params[1];
+                    _y2 = (_params[2] << 8) | _params[3];
+                    if (_column_set) {
+                        _stats.windows++;
+                        _column_set = false;
+                    }
+                }
+                break;
+            case MemoryAccessControl:
+                _madctl = buf[i];
+                break;
+            case PixelFormatSet:
+                _colmod = buf[i];
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void PanelMonitor::reset()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+uint32_t PanelMonitor::bus_time_us(uint32_t freq, uint8_t bits_per_byte)
+{
+    uint64_t bytes = (uint64_t)_stats.commands + _stats.param_bytes + _stats.pixel_bytes;
+    return (uint32_t)(bytes * bits_per_byte * 1000000 / freq);
+}
+
+void PanelMonitor::report(uint32_t freq, uint8_t bits_per_byte)
+{
+    SEGGER_RTT_printf(0, "panel: cmds=%u params=%u pixels=%u windows=%u ramwr=%u overruns=%u bus=%u us\r\n",
+        _stats.commands, _stats.param_bytes, _stats.pixel_bytes, _stats.windows,
+        _stats.memory_writes, _stats.overruns, bus_time_us(freq, bits_per_byte));
+}
+
+uint32_t PanelMonitor::window_bytes()
+{
+    // COLMOD 0x55 is 16 bit, anything else is sent as 18 bit in 3 bytes
+    uint32_t bytes_per_px = ((_colmod & 0x07) == 0x05) ? 2 : 3;
+    if (_x2 < _x1 || _y2 < _y1) {
+        return 0;
+    }
+    return (uint32_t)(_x2 - _x1 + 1) * (_y2 - _y1 + 1) * bytes_per_px;
+}
@@ -0,0 +1,98 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PANEL_MONITOR_H__
+#define __PANEL_MONITOR_H__
+
+#include <stdint.h>
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Decodes the GC9A01 command stream as it leaves common.cpp.
+         *
+         * Follows CASET/RASET/RAMWR/RAMWRC, MADCTL and COLMOD the way the panel
+         * does, counts commands, parameter and pixel bytes, and checks that no
+         * memory write runs past its window. Only plain integer state, so the
+         * same decoder can sit behind a host build of the HAL.
+         */
+        class PanelMonitor
+        {
+        public:
+            struct Stats {
+                uint32_t commands;
+                uint32_t param_bytes;
+                uint32_t pixel_bytes;
+                uint32_t windows;       // CASET/RASET pairs
+                uint32_t memory_writes; // RAMWR and RAMWRC
+                uint32_t overruns;      // pixels written past the end of the window
+            };
+
+            /**
+             * A byte sent with D/C low.
+             */
+            static void command(uint8_t cmd);
+
+            /**
+             * Bytes sent with D/C high.
+             */
+            static void data(const uint8_t *buf, uint32_t len);
+
+            static const Stats &stats() { return _stats; };
+            static void reset();
+
+            /**
+             * Time the bytes seen so far kept the bus busy.
+             *
+             * @param[in] freq SPI clock in Hz.
+             * @param[in] bits_per_byte 8 for 4-wire, 9 for 3-wire SPI.
+             */
+            static uint32_t bus_time_us(uint32_t freq, uint8_t bits_per_byte);
+
+            /**
+             * Print the counters over RTT.
+             */
+            static void report(uint32_t freq, uint8_t bits_per_byte);
+
+            static uint8_t madctl() { return _madctl; };
+            static uint8_t colmod() { return _colmod; };
+
+        private:
+            enum Commands : uint8_t {
+                ColumnAddressSet = 0x2A,
+                RowAddressSet = 0x2B,
+                MemoryWrite = 0x2C,
+                MemoryAccessControl = 0x36,
+                PixelFormatSet = 0x3A,
+                MemoryWriteContinue = 0x3C
+            };
+
+            static uint32_t window_bytes();
+
+            static Stats _stats;
+            static uint8_t _cmd;
+            static uint8_t _param_index;
+            static uint8_t _params[4];
+            static uint16_t _x1, _x2, _y1, _y2;
+            static bool _column_set;
+            static uint32_t _written;
+            static uint8_t _madctl;
+            static uint8_t _colmod;
+        };
+    }
+}
+
+#endif /* __PANEL_MONITOR_H__ */
@@ -0,0 +1,211 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "RenderScheduler.h"
+#include "UiCommandQueue.h"
+
+#include <lvgl/src/lv_misc/lv_gc.h>
+
+using namespace Mytime::Controllers;
+
+RenderScheduler *RenderScheduler::_instance = nullptr;
+
+void RenderScheduler::start()
+{
+    _instance = this;
+    _window_start = lv_tick_get();
+    kick();
+}
+
+void RenderScheduler::kick()
+{
+    RenderScheduler *self = _instance;
+    if (self == nullptr) {
+        return;
+    }
+
+    CriticalSectionLock lock;
+    // Commands still run while suspended, there is just nothing drawn
+    if (self->_run_pending || ((self->_suspended || self->_held) && UiCommandQueue::empty())) {
+        return;
+    }
+
+    int id = self->_event_queue.call(self, &RenderScheduler::run);
+    if (id == 0) {
+        // Queue full, keep any later deadline and let the next kick try again
+        self->_missed_runs++;
+        return;
+    }
+
+    // Bring a later deadline forward to now
+    if (self->_event_id) {
+        self->_event_queue.cancel(self->_event_id);
+    }
+    self->_run_pending = true;
+    self->_event_id = id;
+}
+
+void RenderScheduler::suspend()
+{
+    RenderScheduler *self = _instance;
+    if (self == nullptr) {
+        return;
+    }
+
+    CriticalSectionLock lock;
+    self->_suspended = true;
+    if (self->_event_id) {
+        self->_event_queue.cancel(self->_event_id);
+        self->_event_id = 0;
+    }
+    self->_run_pending = false;
+}
+
+void RenderScheduler::resume()
+{
+    RenderScheduler *self = _instance;
+    if (self == nullptr) {
+        return;
+    }
+
+    {
+        CriticalSectionLock lock;
+        self->_suspended = false;
+    }
+    kick();
+}
+
+bool RenderScheduler::is_suspended()
+{
+    RenderScheduler *self = _instance;
+    return self != nullptr && self->_suspended;
+}
+
+void RenderScheduler::hold()
+{
+    RenderScheduler *self = _instance;
+    if (self == nullptr) {
+        return;
+    }
+
+    CriticalSectionLock lock;
+    self->_held = true;
+    if (self->_event_id) {
+        self->_event_queue.cancel(self->_event_id);
+        self->_event_id = 0;
+    }
+    self->_run_pending = false;
+}
+
+void RenderScheduler::release()
+{
+    RenderScheduler *self = _instance;
+    if (self == nullptr) {
+        return;
+    }
+
+    {
+        CriticalSectionLock lock;
+        self->_held = false;
+    }
+    kick();
+}
+
+void RenderScheduler::run()
+{
+    {
+        CriticalSectionLock lock;
+        _run_pending = false;
+        _event_id = 0;
+    }
+
+    // Changes from other threads are applied here, where LVGL is owned
+    UiCommandQueue::drain();
+
+    {
+        // A command may have suspended or held rendering
+        CriticalSectionLock lock;
+        if (_suspended || _held) {
+            return;
+        }
+    }
+
+    roll_window();
+    _wakeups++;
+
+    lv_task_handler();
+
+    // Commands still queued were posted during the drain, or are claimed
+    // but not yet published. Either way their producer kicks once it is done.
+    int32_t delay = next_delay();
+    if (delay < 0) {
+        // Nothing due, sleep until kicked
+        return;
+    }
+
+    CriticalSectionLock lock;
+    if (!_run_pending) {
+        _event_id = _event_queue.call_in(delay, this, &RenderScheduler::run);
+        if (_event_id == 0) {
+            // Queue full, as in kick() the next kick schedules the run
+            _missed_runs++;
+        }
+    }
+}
+
+uint32_t RenderScheduler::wakeups_per_minute()
+{
+    roll_window();
+    return _wakeups_last_minute;
+}
+
+void RenderScheduler::roll_window()
+{
+    uint32_t elapsed = lv_tick_elaps(_window_start);
+    if (elapsed < 60000) {
+        return;
+    }
+
+    // After a whole idle minute the last full one had no runs at all
+    _wakeups_last_minute = (elapsed < 120000) ? _wakeups : 0;
+    _wakeups = 0;
+    _window_start += elapsed - elapsed % 60000;
+}
+
+int32_t RenderScheduler::next_delay()
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    int32_t delay = -1;
+
+    lv_task_t *task = (lv_task_t *)_lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+    while (task != nullptr) {
+        bool idle = (task->prio == LV_TASK_PRIO_OFF) ||
+            (disp != nullptr && task == disp->refr_task && disp->inv_p == 0);
+
+        if (!idle) {
+            uint32_t elapsed = lv_tick_elaps(task->last_run);
+            int32_t remaining = (elapsed >= task->period) ? 0 : (int32_t)(task->period - elapsed);
+            if (delay < 0 || remaining < delay) {
+                delay = remaining;
+            }
+        }
+
+        task = (lv_task_t *)_lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task);
+    }
+
+    return delay;
+}
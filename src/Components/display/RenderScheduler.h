@@ -0,0 +1,135 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RENDER_SCHEDULER_H__
+#define __RENDER_SCHEDULER_H__
+
+#include "mbed.h"
+#include "events/EventQueue.h"
+#include "platform/NonCopyable.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Runs lv_task_handler() only when LVGL has something due.
+         *
+         * After each run the next call is put on the event queue at the
+         * earliest LVGL task deadline. The refresh task only counts while
+         * there are dirty areas and the animation task switches itself off
+         * when nothing animates, so an idle watch face schedules nothing and
+         * the MCU sleeps until kick() is called.
+         *
+         * This is the only context that calls into LVGL. Each run first
+         * drains the UiCommandQueue, where other threads post their changes.
+         */
+        class RenderScheduler : private mbed::NonCopyable<RenderScheduler>
+        {
+        public:
+            RenderScheduler(events::EventQueue &event_queue) :
+                _event_queue(event_queue),
+                _event_id(0),
+                _run_pending(false),
+                _suspended(false),
+                _held(false),
+                _wakeups(0),
+                _window_start(0),
+                _wakeups_last_minute(0),
+                _missed_runs(0)
+            {
+            }
+
+            /**
+             * Run the LVGL task handler for the first time.
+             *
+             * Call after lv_disp_drv_register().
+             */
+            void start();
+
+            /**
+             * Run the task handler as soon as possible.
+             *
+             * Call after changing LVGL objects. Safe from interrupts.
+             */
+            static void kick();
+
+            /**
+             * Stop running the task handler until resume().
+             *
+             * Nothing is rendered or flushed while suspended, kick() only runs
+             * commands posted to the UiCommandQueue.
+             */
+            static void suspend();
+
+            /**
+             * Undo suspend() and run the task handler straight away.
+             */
+            static void resume();
+
+            static bool is_suspended();
+
+            /**
+             * Leave refreshes to a caller that drives them itself, until
+             * release(). Commands still run, like while suspended.
+             *
+             * Separate from suspend(), so the display powering down or up
+             * during a hardware transition does not end it early.
+             */
+            static void hold();
+            static void release();
+
+            /**
+             * Task handler runs counted over the last full minute.
+             */
+            uint32_t wakeups_per_minute();
+
+            /**
+             * Runs that could not be put on the full event queue. The next
+             * kick() schedules one again.
+             */
+            uint32_t missed_runs() const { return _missed_runs; };
+
+        private:
+            void run();
+
+            /**
+             * Start a new counting window once a minute has passed.
+             */
+            void roll_window();
+
+            /**
+             * Milliseconds until the next LVGL task is due, -1 if none is.
+             */
+            int32_t next_delay();
+
+            events::EventQueue &_event_queue;
+            int _event_id;
+            bool _run_pending;
+            bool _suspended;
+            bool _held;
+
+            uint32_t _wakeups;
+            uint32_t _window_start;
+            uint32_t _wakeups_last_minute;
+            uint32_t _missed_runs;
+
+            static RenderScheduler *_instance;
+        };
+    }
+}
+
+#endif /* __RENDER_SCHEDULER_H__ */
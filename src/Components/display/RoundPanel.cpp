@@ -0,0 +1,81 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "RoundPanel.h"
+
+using namespace Mytime::Controllers;
+
+uint8_t RoundPanel::_row_start[LV_VER_RES_MAX];
+bool RoundPanel::_rounder_enabled = true;
+
+void RoundPanel::init()
+{
+    // Same chord as initLines(): a row h pixels in from the edge of a circle
+    // of radius r is 2 * sqrt(h * (2r - h)) long. Measured from pixel centres.
+    const float r = LV_HOR_RES_MAX / 2;
+    for (lv_coord_t y = 0; y < LV_VER_RES_MAX; y++) {
+        float h = r - LV_MATH_ABS(y + 0.5f - r);
+        float half = sqrtf(h * (2 * r - h));
+        float x = ceilf(r - 0.5f - half);
+        _row_start[y] = (x < 0) ? 0 : (uint8_t)x;
+    }
+}
+
+bool RoundPanel::clip_area(lv_area_t &area)
+{
+    lv_coord_t y1 = LV_MATH_MAX(area.y1, 0);
+    lv_coord_t y2 = LV_MATH_MIN(area.y2, LV_VER_RES_MAX - 1);
+
+    // Rows outside the area that never touch its columns are dropped first
+    while (y1 <= y2 && !row_hits(y1, area)) {
+        y1++;
+    }
+    while (y2 >= y1 && !row_hits(y2, area)) {
+        y2--;
+    }
+    if (y1 > y2) {
+        return false;
+    }
+
+    // The widest row left is the one nearest the centre line
+    lv_coord_t mid = LV_VER_RES_MAX / 2;
+    lv_coord_t widest = (y2 < mid) ? y2 : ((y1 > mid - 1) ? y1 : mid);
+
+    area.x1 = LV_MATH_MAX(area.x1, row_start(widest));
+    area.x2 = LV_MATH_MIN(area.x2, row_end(widest));
+    area.y1 = y1;
+    area.y2 = y2;
+    return true;
+}
+
+void RoundPanel::rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (!_rounder_enabled) {
+        return;
+    }
+
+    // lv_refr_area() sizes its strips by rounding a one column probe at x = 0
+    // from row 0. Clipped to the few centre rows where column 0 shows, it
+    // would split a full frame buffer in two.
+    if (area->x1 == 0 && area->x2 == 0 && area->y1 == 0) {
+        return;
+    }
+
+    // An area completely in a corner is rare enough to render as it is,
+    // a rounder cannot hand back an empty area
+    clip_area(*area);
+}
@@ -0,0 +1,86 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ROUND_PANEL_H__
+#define __ROUND_PANEL_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Geometry of the visible disc of the round GC9A01 glass.
+         *
+         * Holds the first and last visible column of every panel row and uses
+         * it to keep LVGL from rendering the corners nobody can see.
+         */
+        class RoundPanel
+        {
+        public:
+            /**
+             * Build the row table. Call once before any other function.
+             */
+            static void init();
+
+            /**
+             * First visible column of row y.
+             */
+            static lv_coord_t row_start(lv_coord_t y) { return _row_start[y]; };
+
+            /**
+             * Last visible column of row y.
+             */
+            static lv_coord_t row_end(lv_coord_t y) { return LV_HOR_RES_MAX - 1 - _row_start[y]; };
+
+            /**
+             * Shrink an area to the bounding box of its visible pixels.
+             *
+             * @return false if no pixel of the area is visible, the area is
+             * then left untouched.
+             */
+            static bool clip_area(lv_area_t &area);
+
+            /**
+             * Display driver rounder, trims invalidated areas to the disc so
+             * LVGL does not blend or fill the hidden corners.
+             *
+             * The one column area LVGL rounds to size its draw strips is left
+             * as it is.
+             */
+            static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area);
+
+            /**
+             * Turn the rounder off to render whole rows, e.g. while rows are
+             * shown away from where they were drawn.
+             */
+            static void set_rounder_enabled(bool enabled) { _rounder_enabled = enabled; };
+            static bool rounder_enabled() { return _rounder_enabled; };
+
+        private:
+            static bool row_hits(lv_coord_t y, const lv_area_t &area)
+            {
+                return area.x1 <= row_end(y) && area.x2 >= row_start(y);
+            };
+
+            static uint8_t _row_start[LV_VER_RES_MAX];
+            static bool _rounder_enabled;
+        };
+    }
+}
+
+#endif /* __ROUND_PANEL_H__ */
@@ -0,0 +1,186 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "ScrollTransition.h"
+#include "RenderScheduler.h"
+#include "RoundPanel.h"
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+using namespace Mytime::Controllers;
+
+constexpr lv_coord_t ScrollTransition::Rows;
+constexpr lv_coord_t ScrollTransition::StepRows;
+constexpr uint32_t ScrollTransition::FrameMs;
+
+ScrollTransition *ScrollTransition::_instance = nullptr;
+
+void ScrollTransition::start()
+{
+    _instance = this;
+}
+
+bool ScrollTransition::slide(Direction direction)
+{
+    ScrollTransition *self = _instance;
+    if (self == nullptr || RenderScheduler::is_suspended()) {
+        return false;
+    }
+
+    if (self->_active) {
+        self->finish();
+    }
+
+    self->_active = true;
+    self->_direction = direction;
+    self->_revealed = 0;
+    self->_frames = 0;
+    self->_bytes = 0;
+    self->_start_ms = lv_tick_get();
+
+    RenderScheduler::hold();
+
+    // Rows move to other display lines, send them whole
+    self->_flush_round = self->_display_flush.round();
+    self->_rounder = RoundPanel::rounder_enabled();
+    self->_display_flush.set_round(false);
+    RoundPanel::set_rounder_enabled(false);
+
+    // One scroll area over the whole panel, no fixed rows
+    const uint8_t definition[] = {0, 0, (uint8_t)(Rows >> 8), (uint8_t)Rows, 0, 0};
+    self->_display_flush.write_command(VerticalScrollDefinition, definition, sizeof(definition));
+    self->set_scroll_start(0);
+
+    self->_event_id = self->_event_queue.call(self, &ScrollTransition::frame);
+    return true;
+}
+
+bool ScrollTransition::active()
+{
+    ScrollTransition *self = _instance;
+    return self != nullptr && self->_active;
+}
+
+void ScrollTransition::stop()
+{
+    ScrollTransition *self = _instance;
+    if (self != nullptr && self->_active) {
+        self->finish();
+    }
+}
+
+void ScrollTransition::report() const
+{
+    uint32_t elapsed = lv_tick_elaps(_start_ms);
+    SEGGER_RTT_printf(0, "slide: %u frames in %u ms, %u fps, %u bytes/frame, full frame %u bytes\r\n",
+        _frames, elapsed, elapsed ? (_frames * 1000) / elapsed : 0, _frames ? _bytes / _frames : 0,
+        (uint32_t)(LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(lv_color_t)));
+}
+
+void ScrollTransition::frame()
+{
+    _event_id = 0;
+    if (RenderScheduler::is_suspended()) {
+        // Nothing may be drawn, put the scroll back, the whole screen is
+        // redrawn on waking
+        finish();
+        return;
+    }
+
+    lv_disp_t *disp = lv_disp_get_default();
+
+    lv_coord_t revealed = LV_MATH_MIN(_revealed + StepRows, Rows);
+    lv_area_t strip;
+    if (_direction == Up) {
+        lv_area_set(&strip, 0, _revealed, LV_HOR_RES_MAX - 1, revealed - 1);
+    } else {
+        lv_area_set(&strip, 0, Rows - revealed, LV_HOR_RES_MAX - 1, Rows - _revealed - 1);
+    }
+    _revealed = revealed;
+
+    _lv_inv_area(disp, &strip);
+    clip_to_revealed(disp);
+
+    uint32_t sent = _display_flush.bytes_sent();
+    lv_refr_now(disp);
+    _bytes += _display_flush.bytes_sent() - sent;
+    _frames++;
+
+    // Waits for the strip to reach the panel before it scrolls into view
+    set_scroll_start(_direction == Up ? _revealed % Rows : (Rows - _revealed) % Rows);
+
+    if (_revealed >= Rows) {
+        finish();
+        report();
+    } else {
+        _event_id = _event_queue.call_in(FrameMs, this, &ScrollTransition::frame);
+    }
+}
+
+void ScrollTransition::finish()
+{
+    if (_event_id) {
+        _event_queue.cancel(_event_id);
+        _event_id = 0;
+    }
+
+    if (_revealed < Rows) {
+        // Cut short, the rows not revealed yet still hold the old screen
+        lv_obj_invalidate(lv_scr_act());
+    }
+
+    set_scroll_start(0);
+    _display_flush.write_command(NormalDisplayOn, nullptr, 0);
+    _display_flush.set_round(_flush_round);
+    RoundPanel::set_rounder_enabled(_rounder);
+    _active = false;
+    RenderScheduler::release();
+}
+
+void ScrollTransition::set_scroll_start(lv_coord_t row)
+{
+    const uint8_t start[] = {(uint8_t)(row >> 8), (uint8_t)row};
+    _display_flush.write_command(VerticalScrollStart, start, sizeof(start));
+}
+
+void ScrollTransition::clip_to_revealed(lv_disp_t *disp)
+{
+    lv_area_t band;
+    if (_direction == Up) {
+        lv_area_set(&band, 0, 0, LV_HOR_RES_MAX - 1, _revealed - 1);
+    } else {
+        lv_area_set(&band, 0, Rows - _revealed, LV_HOR_RES_MAX - 1, Rows - 1);
+    }
+
+    // Keep the list packed, like AreaCoalescer does
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        lv_area_t clipped;
+        if (disp->inv_area_joined[i] || !_lv_area_intersect(&clipped, &disp->inv_areas[i], &band)) {
+            continue;
+        }
+        lv_area_copy(&disp->inv_areas[count], &clipped);
+        disp->inv_area_joined[count] = 0;
+        count++;
+    }
+    for (uint16_t i = count; i < disp->inv_p; i++) {
+        disp->inv_area_joined[i] = 0;
+    }
+    disp->inv_p = count;
+}
@@ -0,0 +1,148 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SCROLL_TRANSITION_H__
+#define __SCROLL_TRANSITION_H__
+
+#include "mbed.h"
+#include "events/EventQueue.h"
+#include "platform/NonCopyable.h"
+
+#include "DisplayFlush.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Slide between windows with the GC9A01 vertical scroll.
+         *
+         * The whole panel is made one scroll area and the scroll start
+         * address moves a step each frame. Panel row r always holds row r of
+         * the incoming screen: the rows that scroll out at one edge are the
+         * ones the incoming screen needs next, so only that strip is rendered
+         * and sent each frame. The outgoing screen moves with the hardware
+         * scroll and is never redrawn.
+         *
+         * Up brings the new screen in from the bottom, for a push. Down brings
+         * it in from the top, for a pop.
+         *
+         * While a slide runs, RenderScheduler is held and each frame refreshes
+         * only what has been revealed. Areas LVGL invalidates further on are
+         * dropped, they are drawn fresh when their strip comes in.
+         *
+         * A row is shown on other display lines than the one it is drawn for,
+         * where the glass is wider, so the round flush and the rounder are
+         * turned off for the slide and whole rows are sent. Suspending the
+         * display ends the slide.
+         */
+        class ScrollTransition : private mbed::NonCopyable<ScrollTransition>
+        {
+        public:
+            enum Direction : uint8_t {
+                Up,
+                Down
+            };
+
+            enum Commands : uint8_t {
+                NormalDisplayOn = 0x13,
+                VerticalScrollDefinition = 0x33,
+                VerticalScrollStart = 0x37
+            };
+
+            ScrollTransition(events::EventQueue &event_queue, DisplayFlush &display_flush) :
+                _event_queue(event_queue),
+                _display_flush(display_flush),
+                _active(false),
+                _flush_round(false),
+                _rounder(false),
+                _direction(Up),
+                _revealed(0),
+                _event_id(0),
+                _frames(0),
+                _bytes(0),
+                _start_ms(0)
+            {
+            }
+
+            /**
+             * Make slide() available. Call after lv_disp_drv_register().
+             */
+            void start();
+
+            /**
+             * Slide in the screen LVGL holds now.
+             *
+             * Call from the render context straight after changing the
+             * screen, before it is refreshed. A slide still running is
+             * finished at once. Nothing slides while the display is
+             * suspended.
+             *
+             * @return false if no slide was started.
+             */
+            static bool slide(Direction direction);
+
+            static bool active();
+
+            /**
+             * Finish a running slide at once, e.g. before the panel sleeps.
+             */
+            static void stop();
+
+            /**
+             * Print frames, frame rate and bytes per frame of the last slide.
+             */
+            void report() const;
+
+        private:
+            static constexpr lv_coord_t Rows = LV_VER_RES_MAX;
+            static constexpr lv_coord_t StepRows = 24;
+            static constexpr uint32_t FrameMs = 16;
+
+            void frame();
+
+            /**
+             * Jump to the end, leave scroll mode and hand refreshes back.
+             */
+            void finish();
+
+            void set_scroll_start(lv_coord_t row);
+
+            /**
+             * Cut the pending areas down to the rows revealed so far.
+             */
+            void clip_to_revealed(lv_disp_t *disp);
+
+            events::EventQueue &_event_queue;
+            DisplayFlush &_display_flush;
+
+            bool _active;
+            bool _flush_round;
+            bool _rounder;
+            Direction _direction;
+            lv_coord_t _revealed;
+            int _event_id;
+
+            uint32_t _frames;
+            uint32_t _bytes;
+            uint32_t _start_ms;
+
+            static ScrollTransition *_instance;
+        };
+    }
+}
+
+#endif /* __SCROLL_TRANSITION_H__ */
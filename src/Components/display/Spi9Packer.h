@@ -0,0 +1,102 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SPI9_PACKER_H__
+#define __SPI9_PACKER_H__
+
+#include "mbed.h"
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * 9 bit 3-wire SPI words for 8 bit SPI hardware.
+         *
+         * Each word is the D/C bit followed by a data byte. Words are packed
+         * MSB first into a byte stream, 8 words fill exactly 9 bytes. A
+         * transfer that ends part way through a byte is padded with zero bits,
+         * the panel drops the incomplete word when chip select goes high after
+         * it.
+         */
+        class Spi9Packer
+        {
+        public:
+            static constexpr uint32_t Bytes = 32 * 9;
+
+            Spi9Packer() : _buf(), _bits(0) {};
+
+            /**
+             * Add a word.
+             *
+             * @return true when the buffer is full and has to be sent.
+             */
+            bool put(uint8_t dc, uint8_t data)
+            {
+                // Left align the 9 bits in a 16 bit window starting at the current bit
+                uint32_t byte = _bits >> 3;
+                uint16_t window = (uint16_t)(((dc ? 0x100 : 0) | data) << (7 - (_bits & 7)));
+
+                _buf[byte] |= window >> 8;
+                _buf[byte + 1] |= window & 0xFF;
+                _bits += 9;
+
+                return _bits == Bytes * 8;
+            };
+
+            const uint8_t* data() const { return _buf; };
+
+            /**
+             * Bytes to send, the last one padded with zero bits.
+             */
+            uint32_t bytes() const { return (_bits + 7) / 8; };
+
+            /**
+             * Empty the buffer once its bytes are sent.
+             */
+            void clear()
+            {
+                memset(_buf, 0, bytes());
+                _bits = 0;
+            };
+
+            /**
+             * Clock one word out on two pins, for panels without the hardware.
+             *
+             * The D/C bit goes first, then the data MSB first. The panel takes
+             * each bit on the rising edge of the clock.
+             */
+            template <typename Pin>
+            static void bitbang(Pin &sck, Pin &mosi, uint8_t dc, uint8_t data)
+            {
+                sck = 0;
+                mosi = dc ? 1 : 0;
+                sck = 1;
+
+                for (uint8_t bit = 0x80; bit; bit >>= 1)
+                {
+                    sck = 0;
+                    mosi = (data & bit) ? 1 : 0;
+                    sck = 1;
+                }
+            };
+
+        private:
+            uint8_t _buf[Bytes];
+            uint32_t _bits;
+        };
+    }
+}
+
+#endif /* __SPI9_PACKER_H__ */
@@ -0,0 +1,107 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "UiCommandQueue.h"
+#include "RenderScheduler.h"
+
+using namespace Mytime::Controllers;
+
+// Sequence numbers count in turns of Size, a zeroed slot is free for turn 0
+UiCommandQueue::Slot UiCommandQueue::_slots[UiCommandQueue::Size];
+volatile uint32_t UiCommandQueue::_tail = 0;
+volatile uint32_t UiCommandQueue::_head = 0;
+
+volatile uint32_t UiCommandQueue::_posted = 0;
+volatile uint32_t UiCommandQueue::_dropped = 0;
+uint32_t UiCommandQueue::_high_water = 0;
+
+static inline uint32_t turn_of(uint32_t pos)
+{
+    return pos & ~(UiCommandQueue::Size - 1);
+}
+
+bool UiCommandQueue::post(mbed::Callback<void()> command)
+{
+    uint32_t pos = core_util_atomic_load_u32(&_tail);
+    Slot *slot;
+
+    while (true) {
+        slot = &_slots[pos & (Size - 1)];
+        int32_t diff = (int32_t)(core_util_atomic_load_u32(&slot->seq) - turn_of(pos));
+
+        if (diff == 0) {
+            // Free for this turn, claim it unless another producer got there first
+            if (core_util_atomic_cas_u32(&_tail, &pos, pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Still holds a command from the turn before, the ring is full
+            core_util_atomic_incr_u32(&_dropped, 1);
+            return false;
+        } else {
+            pos = core_util_atomic_load_u32(&_tail);
+        }
+    }
+
+    slot->command = command;
+    core_util_atomic_store_u32(&slot->seq, turn_of(pos) + 1);
+
+    core_util_atomic_incr_u32(&_posted, 1);
+    // The render context may have run it already, head is then past pos
+    int32_t depth = (int32_t)(pos + 1 - core_util_atomic_load_u32(&_head));
+    if (depth > (int32_t)_high_water) {
+        // Only a statistic, a lost race just undercounts
+        _high_water = depth;
+    }
+
+    RenderScheduler::kick();
+    return true;
+}
+
+uint32_t UiCommandQueue::drain()
+{
+    uint32_t count = 0;
+
+    // Commands posted by the commands run here wait for the next drain
+    uint32_t tail = core_util_atomic_load_u32(&_tail);
+    while (_head != tail) {
+        Slot *slot = &_slots[_head & (Size - 1)];
+        if (core_util_atomic_load_u32(&slot->seq) != turn_of(_head) + 1) {
+            // Empty, or the next slot is claimed but not published yet
+            break;
+        }
+
+        mbed::Callback<void()> command = slot->command;
+        slot->command = nullptr;
+        // Move head on before freeing the slot, so a producer never sees more than Size waiting
+        uint32_t turn = turn_of(_head);
+        core_util_atomic_store_u32(&_head, _head + 1);
+        core_util_atomic_store_u32(&slot->seq, turn + Size);
+
+        if (command) {
+            command();
+        }
+        count++;
+    }
+
+    return count;
+}
+
+bool UiCommandQueue::empty()
+{
+    return core_util_atomic_load_u32(&_head) == core_util_atomic_load_u32(&_tail);
+}
@@ -0,0 +1,92 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UI_COMMAND_QUEUE_H__
+#define __UI_COMMAND_QUEUE_H__
+
+#include "mbed.h"
+#include "platform/Callback.h"
+
+namespace Mytime {
+    namespace Controllers {
+        /**
+         * Work on LVGL objects, handed to the one context that renders.
+         *
+         * LVGL is not thread safe. Only RenderScheduler, on the shared event
+         * queue, calls into it. Any other thread or interrupt that needs to
+         * change the UI posts a command here instead, and the scheduler runs
+         * the commands before the LVGL task handler.
+         *
+         * The queue is a fixed ring of Size slots, each with a sequence number.
+         * Producers claim a slot with a compare-and-swap on the tail and then
+         * publish it. The consumer takes slots in order, as long as they are
+         * published. Nothing blocks and no lock is taken on either side. A
+         * producer that is interrupted between claiming and publishing only
+         * holds up the commands after its own until it resumes.
+         */
+        class UiCommandQueue
+        {
+        public:
+            static constexpr uint32_t Size = 32;
+
+            /**
+             * Queue a command and get the render context to run it.
+             *
+             * Safe from any thread and from interrupts.
+             *
+             * @return false when the queue is full and the command was dropped.
+             */
+            static bool post(mbed::Callback<void()> command);
+
+            /**
+             * Run the commands queued so far. Render context only.
+             *
+             * @return the number of commands run.
+             */
+            static uint32_t drain();
+
+            static bool empty();
+
+            static uint32_t posted() { return _posted; };
+            static uint32_t dropped() { return _dropped; };
+
+            /**
+             * Most commands ever waiting at once.
+             */
+            static uint32_t high_water() { return _high_water; };
+
+        private:
+            static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+
+            struct Slot
+            {
+                // Slot index when free for that turn, index + 1 once published
+                volatile uint32_t seq;
+                mbed::Callback<void()> command;
+            };
+
+            static Slot _slots[Size];
+            static volatile uint32_t _tail;
+            static volatile uint32_t _head;
+
+            static volatile uint32_t _posted;
+            static volatile uint32_t _dropped;
+            static uint32_t _high_water;
+        };
+    }
+}
+
+#endif /* __UI_COMMAND_QUEUE_H__ */
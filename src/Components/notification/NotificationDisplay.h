@@ -20,15 +20,27 @@
 #include "mbed.h"
 #include "Api.h"
 #include "Window.h"
+#include "NotificationManager.h"
 
 extern "C"{
   #include "SEGGER_RTT.h"
 }
 
 extern events::EventQueue app_queue;
+extern Mytime::Controllers::NotificationManager notification_manager;
 
 static Mytime::Windows::Window* not_main_window;
 static TextLayer *not_text_layer;
+static bool not_loaded = false;
+static bool not_visible = false;
+static Mytime::Controllers::NotificationManager::Notification::Id not_shown_id;
+
+static void notif_show(const Mytime::Controllers::NotificationManager::Notification& notif)
+{
+    // Cached by id, paging back to a message does not lay it out again
+    text_layer_set_round_text(not_text_layer, notif.message, notif.id);
+    not_shown_id = notif.id;
+}
 
 static void notif_main_window_load(Mytime::Windows::Window* w)
 {
@@ -44,6 +56,7 @@ static void notif_main_window_load(Mytime::Windows::Window* w)
     // Create the TextLayer with specific bounds
     GRect bounds = GRect(0, 120, 200, 190);
     not_text_layer = text_layer_create(w, bounds);
+    not_loaded = true;
     
     // text_layer_set_long_mode(not_text_layer, LV_LABEL_LONG_BREAK);  // ** Set this before the text to make work
     // text_layer_set_size(not_text_layer, GSize{.w = 200, .h = 75}); // ** Set this after the long mode
@@ -56,9 +69,38 @@ static void notif_main_window_load(Mytime::Windows::Window* w)
     // SEGGER_RTT_printf(0, "mwl X\n\r");
 }
 
+static void notif_main_window_appear()
+{
+    // Pushed again for a new message, the layer is kept from last time
+    not_visible = true;
+
+    Mytime::Controllers::NotificationManager::Notification notif = notification_manager.GetLastNotification();
+    if (notif.valid)
+    {
+        notif_show(notif);
+    }
+    else
+    {
+        text_layer_set_round_text(not_text_layer, "Lorem ipsum dolor sit amet, consectetur adipiscing elit,"
+                             "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua."
+                             "Ut enim ad minim veniam, quis nostrud exercitation ullamco"
+                             "laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure"
+                             "dolor in reprehenderit in voluptate velit esse cillum dolore"
+                             "eu fugiat nulla pariatur."
+                             "Excepteur sint occaecat cupidatat non proident, sunt in culpa"
+                             "qui officia deserunt mollit anim id est laborum.");
+    }
+}
+
+static void notif_main_window_disappear()
+{
+    not_visible = false;
+}
+
 static void notif_main_window_unload(/*Window *window*/)
 {
     // SEGGER_RTT_printf(0, "mwu E\r\n");
+    not_loaded = false;
     // SEGGER_RTT_printf(0, "mwu X\r\n");
 }
 
@@ -76,15 +118,20 @@ namespace Mytime {
             {
                 // SEGGER_RTT_printf(0, "wi E\r\n");
 
-                not_main_window = window_create();
-
-                window_set_window_handlers(not_main_window, (Mytime::Windows::WindowHandlers)
+                if (not_main_window == nullptr)
                 {
-                    .load = mbed::callback(&notif_main_window_load),
-                    .unload = mbed::callback(&notif_main_window_unload)
-                });
+                    not_main_window = window_create();
 
-                window_stack_push(not_main_window);
+                    window_set_window_handlers(not_main_window, (Mytime::Windows::WindowHandlers)
+                    {
+                        .load = mbed::callback(&notif_main_window_load),
+                        .appear = mbed::callback(&notif_main_window_appear),
+                        .disappear = mbed::callback(&notif_main_window_disappear),
+                        .unload = mbed::callback(&notif_main_window_unload)
+                    });
+                }
+
+                window_stack_push(not_main_window, true);
 
                 // SEGGER_RTT_printf(0, "wi X\r\n");
             };
@@ -93,19 +140,53 @@ namespace Mytime {
             {
                 // SEGGER_RTT_printf(0, "wdi E\r\n");
                 window_stack_pop(false);
-                window_destroy(not_main_window);
                 // SEGGER_RTT_printf(0, "wdi X\r\n");
             };
 
-            void main()
+            /**
+             * Page to the previous or next notification. Posted to the UiCommandQueue.
+             */
+            void show_previous()
+            {
+                if (not_visible)
+                {
+                    Mytime::Controllers::NotificationManager::Notification notif = notification_manager.GetPrevious(not_shown_id);
+                    if (notif.valid)
+                    {
+                        notif_show(notif);
+                    }
+                }
+            };
+
+            void show_next()
             {
-                // SEGGER_RTT_printf(0, "-----------------------wm E\r\n");                 
+                if (not_visible)
+                {
+                    Mytime::Controllers::NotificationManager::Notification notif = notification_manager.GetNext(not_shown_id);
+                    if (notif.valid)
+                    {
+                        notif_show(notif);
+                    }
+                }
+            };
 
-                init();
-                app_queue.dispatch_forever();
-                deinit();
+            /**
+             * Scroll a long notification by a screen. Posted to the UiCommandQueue.
+             */
+            void scroll_up()
+            {
+                if (not_visible)
+                {
+                    text_layer_scroll(not_text_layer, false);
+                }
+            };
 
-                // SEGGER_RTT_printf(0, "-----------------------wm X\r\n");                 
+            void scroll_down()
+            {
+                if (not_visible)
+                {
+                    text_layer_scroll(not_text_layer, true);
+                }
             };
         };
     }
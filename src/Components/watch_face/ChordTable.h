@@ -0,0 +1,168 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CHORD_TABLE_H__
+#define __CHORD_TABLE_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+typedef struct
+{
+    int16_t y;
+    int16_t max_length;
+} Lines;
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Text line widths for a round area.
+         *
+         * Lines are line_height apart starting from the top of a circle of radius
+         * r. y is measured up from the centre and max_length is the chord at y,
+         * lines under MinLength wide are left out.
+         *
+         * Tables are built with integer maths on first use and kept per
+         * (radius, line height), so opening a text window again costs a lookup.
+         * get() hands out a copy, about 140 bytes, so building another table
+         * never changes one a caller is still using.
+         */
+        class ChordTable
+        {
+        public:
+            static constexpr uint8_t MaxLines = 32;
+            static constexpr int16_t MinLength = 10;
+
+            /**
+             * floor(sqrt(v)) without floating point.
+             */
+            static constexpr uint32_t isqrt(uint32_t v)
+            {
+                uint32_t res = 0;
+                uint32_t bit = 1UL << 30;
+
+                while (bit > v)
+                {
+                    bit >>= 2;
+                }
+                while (bit)
+                {
+                    if (v >= res + bit)
+                    {
+                        v -= res + bit;
+                        res = (res >> 1) + bit;
+                    }
+                    else
+                    {
+                        res >>= 1;
+                    }
+                    bit >>= 2;
+                }
+                return res;
+            };
+
+            /**
+             * Chord length at y from the centre of a circle of radius r, as
+             * (int)(2 * sqrt(h * (2r - h))) with h the distance from the top.
+             */
+            static constexpr int16_t chord(int16_t r, int16_t y)
+            {
+                return (int16_t)isqrt(4 * (uint32_t)LV_MATH_ABS(r - y) * (uint32_t)(2 * r - LV_MATH_ABS(r - y)));
+            };
+
+            /**
+             * Table for a radius and line height.
+             */
+            static ChordTable get(int16_t r, int16_t line_height)
+            {
+                static ChordTable cache[CacheSize];
+                static uint8_t next = 0;
+
+                for (uint8_t i = 0; i < CacheSize; i++)
+                {
+                    if (cache[i]._r == r && cache[i]._line_height == line_height)
+                    {
+                        return cache[i];
+                    }
+                }
+
+                ChordTable &entry = cache[next];
+                next = (next + 1) % CacheSize;
+                entry.build(r, line_height);
+                return entry;
+            };
+
+            const Lines* begin() const { return _lines; };
+            const Lines* end() const { return _lines + _count; };
+            uint8_t size() const { return _count; };
+
+            /**
+             * Longest max_length in the table.
+             */
+            int16_t widest() const { return _widest; };
+
+        private:
+            static constexpr uint8_t CacheSize = 4;
+
+            ChordTable() : _r(0), _line_height(0), _count(0), _widest(0), _lines() {};
+
+            void build(int16_t r, int16_t line_height)
+            {
+                _r = r;
+                _line_height = line_height;
+                _count = 0;
+                _widest = 0;
+
+                if (line_height <= 0)
+                {
+                    return;
+                }
+
+                for (int16_t y = r; y > -r; y -= line_height)
+                {
+                    int16_t length = chord(r, y);
+                    if (length <= MinLength)
+                    {
+                        continue;
+                    }
+                    if (_count >= MaxLines)
+                    {
+                        SEGGER_RTT_printf(0, "ChordTable: r=%d lh=%d too many lines\r\n", r, line_height);
+                        break;
+                    }
+                    _lines[_count++] = {y, length};
+                    _widest = LV_MATH_MAX(_widest, length);
+                }
+            };
+
+            int16_t _r;
+            int16_t _line_height;
+            uint8_t _count;
+            int16_t _widest;
+            Lines _lines[MaxLines];
+        };
+
+        static_assert(ChordTable::chord(120, 0) == 240, "chord through the centre is the diameter");
+        static_assert(ChordTable::chord(75, 59) == 92, "chord 16 px below the top");
+    }
+}
+
+#endif /* __CHORD_TABLE_H__ */
@@ -0,0 +1,273 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GLYPH_ADVANCE_H__
+#define __GLYPH_ADVANCE_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+#include <string.h>
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Text widths from a per-font table of glyph advances.
+         *
+         * Printable ASCII advances are looked up in the font once and kept, other
+         * code points go to the font every time. Widths follow _lv_txt_get_size()
+         * on a single line: glyph advance including kerning with the next glyph,
+         * plus letter space between glyphs.
+         *
+         * With a kerning font the unkerned advance comes from the table and the
+         * kerning of a pair is kept as the difference to it, in a small direct
+         * mapped cache filled as pairs are met. The font rounds after adding
+         * the kerning, so the difference is taken from the font, not worked out.
+         *
+         * A word is measured once. Joining it to the previous word on a line
+         * costs join(), so a line's width is a running sum and fitting words to
+         * lines is linear in the text length.
+         *
+         * get() hands out a copy, about 500 bytes, so loading another font
+         * never changes a table a caller is still using. Kerning pairs met
+         * through a copy stay with that copy.
+         */
+        class GlyphAdvance
+        {
+        public:
+            /**
+             * Advance table for a font and letter space, filled on first use.
+             *
+             * The last few fonts used are kept.
+             */
+            static GlyphAdvance get(const lv_font_t *font, lv_coord_t letter_space)
+            {
+                static GlyphAdvance cache[CacheSize];
+                static uint8_t next = 0;
+
+                for (uint8_t i = 0; i < CacheSize; i++)
+                {
+                    if (cache[i]._font == font && cache[i]._letter_space == letter_space)
+                    {
+                        return cache[i];
+                    }
+                }
+
+                GlyphAdvance &entry = cache[next];
+                next = (next + 1) % CacheSize;
+                entry.load(font, letter_space);
+                return entry;
+            };
+
+            /**
+             * Width of a word as _lv_txt_get_size() would give it on its own.
+             *
+             * @param first_out first code point of the word
+             * @param last_out last code point of the word
+             * @param limit stop measuring once the width is past this, the
+             *              result is then only known to be over it
+             */
+            lv_coord_t word(const char *txt, uint32_t len, uint32_t &first_out, uint32_t &last_out,
+                lv_coord_t limit = LV_COORD_MAX) const
+            {
+                uint32_t i = 0;
+                int32_t width = 0;
+                uint32_t letter = 0;
+                uint32_t letter_next = 0;
+
+                first_out = 0;
+                last_out = 0;
+                if (len == 0)
+                {
+                    return 0;
+                }
+
+                letter = _lv_txt_encoded_next(txt, &i);
+                first_out = letter;
+                while (true)
+                {
+                    if (i < len)
+                    {
+                        letter_next = _lv_txt_encoded_next(txt, &i);
+                    }
+                    else
+                    {
+                        letter_next = 0;
+                    }
+
+                    // Zero width glyphs get no letter space, as in _lv_txt_get_width()
+                    lv_coord_t glyph = advance(letter, letter_next);
+                    if (glyph > 0)
+                    {
+                        width += glyph + _letter_space;
+                    }
+                    if (letter_next == 0 || width - _letter_space > limit)
+                    {
+                        break;
+                    }
+                    letter = letter_next;
+                }
+                last_out = letter;
+
+                return (width > 0) ? width - _letter_space : 0;
+            };
+
+            /**
+             * Longest start of a word that fits max_width, cut between glyphs.
+             *
+             * Measures no further than the first glyph that does not fit. At
+             * least one glyph is taken, so a line always makes progress.
+             *
+             * @param bytes_out length of the part that fits
+             * @param last_out last code point of that part
+             */
+            lv_coord_t fit(const char *txt, uint32_t len, lv_coord_t max_width, uint16_t &bytes_out, uint32_t &last_out) const
+            {
+                uint32_t i = 0;
+                int32_t width = 0;
+
+                bytes_out = 0;
+                last_out = 0;
+                while (i < len)
+                {
+                    uint32_t next = i;
+                    uint32_t letter = _lv_txt_encoded_next(txt, &next);
+                    int32_t test = width + advance(letter, 0) + (bytes_out ? _letter_space : 0);
+
+                    if (test > max_width && bytes_out)
+                    {
+                        break;
+                    }
+                    width = test;
+                    bytes_out = next;
+                    last_out = letter;
+                    i = next;
+                }
+
+                return width;
+            };
+
+            /**
+             * Width added by putting spaces and the next word after a word.
+             *
+             * Covers the kerning of the word's last glyph against the space, the
+             * spaces themselves and the letter space either side of them.
+             */
+            lv_coord_t join(uint32_t last, uint32_t first_next, uint16_t spaces = 1) const
+            {
+                return (advance(last, ' ') - advance(last, 0)) + (spaces - 1) * (advance(' ', ' ') + _letter_space) +
+                    advance(' ', first_next) + 2 * _letter_space;
+            };
+
+            /**
+             * Advance of a glyph followed by another, 0 for none.
+             */
+            lv_coord_t advance(uint32_t letter, uint32_t letter_next) const
+            {
+                if (letter >= FirstCached && letter <= LastCached)
+                {
+                    uint8_t base = _advance[letter - FirstCached];
+                    if (base != Uncached)
+                    {
+                        if (!_kerning || letter_next == 0)
+                        {
+                            return base;
+                        }
+                        if (letter_next >= FirstCached && letter_next <= LastCached)
+                        {
+                            return base + kerning(letter, letter_next, base);
+                        }
+                    }
+                }
+                return lv_font_get_glyph_width(_font, letter, letter_next);
+            };
+
+            lv_coord_t line_height() const { return lv_font_get_line_height(_font); };
+            lv_coord_t letter_space() const { return _letter_space; };
+
+        private:
+            static constexpr uint8_t CacheSize = 4;
+            static constexpr uint32_t FirstCached = 0x20;
+            static constexpr uint32_t LastCached = 0x7E;
+            // Advance too wide for the table, ask the font
+            static constexpr uint8_t Uncached = 0xFF;
+            static constexpr uint8_t PairCacheSize = 128;
+
+            static_assert((PairCacheSize & (PairCacheSize - 1)) == 0, "pair cache is indexed by mask");
+
+            /**
+             * Kerning of an ASCII pair, letter 0 marks a free slot.
+             */
+            struct Pair
+            {
+                uint8_t letter;
+                uint8_t letter_next;
+                int8_t kerning;
+            };
+
+            GlyphAdvance() : _font(nullptr), _letter_space(0), _kerning(false), _advance(), _pairs() {};
+
+            lv_coord_t kerning(uint32_t letter, uint32_t letter_next, uint8_t base) const
+            {
+                Pair &pair = _pairs[(letter * 31 + letter_next) & (PairCacheSize - 1)];
+                if (pair.letter == letter && pair.letter_next == letter_next)
+                {
+                    return pair.kerning;
+                }
+
+                lv_coord_t kerning = lv_font_get_glyph_width(_font, letter, letter_next) - base;
+                if (kerning >= INT8_MIN && kerning <= INT8_MAX)
+                {
+                    pair = {(uint8_t)letter, (uint8_t)letter_next, (int8_t)kerning};
+                }
+                return kerning;
+            };
+
+            void load(const lv_font_t *font, lv_coord_t letter_space)
+            {
+                _font = font;
+                _letter_space = letter_space;
+                _kerning = has_kerning(font);
+
+                for (uint32_t c = FirstCached; c <= LastCached; c++)
+                {
+                    uint16_t width = lv_font_get_glyph_width(font, c, 0);
+                    _advance[c - FirstCached] = (width < Uncached) ? width : Uncached;
+                }
+                memset(_pairs, 0, sizeof(_pairs));
+            };
+
+            static bool has_kerning(const lv_font_t *font)
+            {
+                // Only the built in font format carries a kerning table we can see
+                if (font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt)
+                {
+                    return true;
+                }
+                const lv_font_fmt_txt_dsc_t *dsc = (const lv_font_fmt_txt_dsc_t *)font->dsc;
+                return dsc->kern_dsc != NULL;
+            };
+
+            const lv_font_t *_font;
+            lv_coord_t _letter_space;
+            bool _kerning;
+            uint8_t _advance[LastCached - FirstCached + 1];
+            mutable Pair _pairs[PairCacheSize];
+        };
+    }
+}
+
+#endif /* __GLYPH_ADVANCE_H__ */
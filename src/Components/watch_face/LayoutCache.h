@@ -0,0 +1,168 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LAYOUT_CACHE_H__
+#define __LAYOUT_CACHE_H__
+
+#include "mbed.h"
+#include "TextLayout.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Finished round text layouts of the last few messages shown.
+         *
+         * Entries are keyed by message id, font, letter space and diameter.
+         * Line spacing is the font's own line height, so the font covers it.
+         * The text length and a checksum are kept as well, notification ids
+         * wrap after 256 messages and must not pick up an old layout.
+         *
+         * The least recently used entry is replaced when the cache is full.
+         */
+        class LayoutCache
+        {
+        public:
+            // Text without a message id is never cached
+            static constexpr uint32_t NoId = 0xFFFFFFFF;
+
+            /**
+             * Lay out text, or copy the layout from the cache.
+             */
+            static void layout(TextLayout &out, uint32_t id, const TextSpan &text,
+                const GlyphAdvance &glyphs, const ChordTable &lines, const lv_font_t *font, lv_coord_t diameter)
+            {
+                LayoutCache &cache = instance();
+
+                if (id == NoId)
+                {
+                    out.layout(text, glyphs, lines);
+                    return;
+                }
+
+                uint32_t sum = checksum(text);
+                cache._clock++;
+
+                for (uint8_t i = 0; i < Size; i++)
+                {
+                    Entry &entry = cache._entries[i];
+                    if (entry.valid && entry.id == id && entry.font == font && entry.diameter == diameter &&
+                        entry.letter_space == glyphs.letter_space() && entry.line_height == glyphs.line_height() &&
+                        entry.len == text.len && entry.sum == sum)
+                    {
+                        entry.last_used = cache._clock;
+                        out = entry.layout;
+                        cache._hits++;
+                        return;
+                    }
+                }
+
+                uint32_t start = us_ticker_read();
+                out.layout(text, glyphs, lines);
+                cache._miss_us += us_ticker_read() - start;
+                cache._misses++;
+
+                Entry *victim = &cache._entries[0];
+                for (uint8_t i = 1; i < Size && victim->valid; i++)
+                {
+                    Entry &entry = cache._entries[i];
+                    if (!entry.valid || entry.last_used < victim->last_used)
+                    {
+                        victim = &entry;
+                    }
+                }
+
+                victim->valid = true;
+                victim->id = id;
+                victim->font = font;
+                victim->diameter = diameter;
+                victim->letter_space = glyphs.letter_space();
+                victim->line_height = glyphs.line_height();
+                victim->len = text.len;
+                victim->sum = sum;
+                victim->last_used = cache._clock;
+                victim->layout = out;
+            };
+
+            static uint32_t hits() { return instance()._hits; };
+            static uint32_t misses() { return instance()._misses; };
+
+            /**
+             * Hits as a percentage of all cached lookups.
+             */
+            static uint8_t hit_rate()
+            {
+                LayoutCache &cache = instance();
+                uint32_t total = cache._hits + cache._misses;
+                return total ? (cache._hits * 100) / total : 0;
+            };
+
+            /**
+             * Layout time saved, each hit counted at the average miss cost.
+             */
+            static uint32_t time_saved_us()
+            {
+                LayoutCache &cache = instance();
+                return cache._misses ? (uint32_t)(((uint64_t)cache._miss_us * cache._hits) / cache._misses) : 0;
+            };
+
+        private:
+            static constexpr uint8_t Size = 4;
+
+            struct Entry
+            {
+                bool valid;
+                uint32_t id;
+                const lv_font_t *font;
+                lv_coord_t diameter;
+                lv_coord_t letter_space;
+                lv_coord_t line_height;
+                uint16_t len;
+                uint32_t sum;
+                uint32_t last_used;
+                TextLayout layout;
+            };
+
+            LayoutCache() : _entries(), _clock(0), _hits(0), _misses(0), _miss_us(0) {};
+
+            static LayoutCache& instance()
+            {
+                static LayoutCache cache;
+                return cache;
+            };
+
+            // FNV-1a, a pass over a message is noise next to laying it out
+            static uint32_t checksum(const TextSpan &text)
+            {
+                uint32_t sum = 2166136261UL;
+                for (uint16_t i = 0; i < text.len; i++)
+                {
+                    sum = (sum ^ (uint8_t)text.data[i]) * 16777619UL;
+                }
+                return sum;
+            };
+
+            Entry _entries[Size];
+            uint32_t _clock;
+            uint32_t _hits;
+            uint32_t _misses;
+            uint32_t _miss_us;
+        };
+    }
+}
+
+#endif /* __LAYOUT_CACHE_H__ */
@@ -0,0 +1,336 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ROUND_TEXT_H__
+#define __ROUND_TEXT_H__
+
+#include "mbed.h"
+#include "GlyphAdvance.h"
+#include "ChordTable.h"
+#include "TextLayout.h"
+#include "LayoutCache.h"
+
+#include <lvgl/lvgl.h>
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Word wrapped text in a circle, drawn by one LVGL object.
+         *
+         * The object holds one copy of the text and the line records, and its
+         * design callback draws every line clipped to its chord. It has no
+         * background of its own. Compared to a label per line there is a single
+         * object to walk on each refresh and one allocation for the text.
+         *
+         * Text that does not fit the circle is scrolled a screen at a time. The
+         * chords change width from line to line, so lines cannot simply shift
+         * up; each screen is its own layout starting after the last one. The
+         * last screen that can be reached ends in an ellipsis.
+         */
+        class RoundText
+        {
+        public:
+            /**
+             * Create the object, as wide and high as the circle it fills.
+             */
+            static lv_obj_t* create(lv_obj_t *parent, lv_coord_t diameter, const TextSpan &text)
+            {
+                lv_obj_t *obj = lv_obj_create(parent, NULL);
+                if (obj == NULL)
+                {
+                    return NULL;
+                }
+
+                if (ancestor_signal() == NULL)
+                {
+                    ancestor_signal() = lv_obj_get_signal_cb(obj);
+                }
+
+                Ext *ext = (Ext *)lv_obj_allocate_ext_attr(obj, sizeof(Ext));
+                if (ext == NULL)
+                {
+                    lv_obj_del(obj);
+                    return NULL;
+                }
+                ext->text = NULL;
+                ext->len = 0;
+                ext->radius = diameter / 2;
+                ext->line_height = 0;
+                ext->screen = 0;
+                ext->screen_start[0] = 0;
+                ext->layout = TextLayout();
+                ext->ahead = TextLayout();
+
+                lv_obj_set_size(obj, diameter, diameter);
+                lv_obj_set_design_cb(obj, &RoundText::design_cb);
+                lv_obj_set_signal_cb(obj, &RoundText::signal_cb);
+                lv_obj_set_click(obj, false);
+
+                set_text(obj, text);
+                return obj;
+            };
+
+            /**
+             * Replace the text and lay out its first screen.
+             *
+             * @param id message id, the first screen is cached under it and
+             *           reused when the same message is shown again
+             */
+            static void set_text(lv_obj_t *obj, const TextSpan &text, uint32_t id = LayoutCache::NoId)
+            {
+                Ext *ext = (Ext *)lv_obj_get_ext_attr(obj);
+
+                if (ext->text)
+                {
+                    lv_mem_free(ext->text);
+                    ext->text = NULL;
+                }
+                ext->len = 0;
+                ext->screen = 0;
+                ext->screen_start[0] = 0;
+                ext->layout = TextLayout();
+                ext->ahead = TextLayout();
+
+                ext->text = (char *)lv_mem_alloc(text.len + 1);
+                if (ext->text == NULL)
+                {
+                    SEGGER_RTT_printf(0, "RoundText: no memory for %d bytes\r\n", text.len + 1);
+                    return;
+                }
+                // A NUL would end a line early when it is drawn, keep it a space
+                for (uint16_t i = 0; i < text.len; i++)
+                {
+                    ext->text[i] = text.data[i] ? text.data[i] : ' ';
+                }
+                ext->text[text.len] = '\0';
+                ext->len = text.len;
+
+                const lv_font_t *font = lv_obj_get_style_value_font(obj, LV_LABEL_PART_MAIN);
+                const GlyphAdvance glyphs = glyphs_of(obj);
+                ext->line_height = glyphs.line_height();
+
+                const ChordTable lines = ChordTable::get(ext->radius, ext->line_height);
+                LayoutCache::layout(ext->layout, id, TextSpan(ext->text, ext->len), glyphs, lines, font, ext->radius * 2);
+                lay_ahead(obj, ext);
+
+                lv_obj_invalidate(obj);
+            };
+
+            /**
+             * Show the next or previous screen of text.
+             *
+             * Only the screen shown and the one after it are ever laid out.
+             * Nothing is rebuilt, the object just redraws its own area.
+             *
+             * @return false at either end of the text.
+             */
+            static bool scroll(lv_obj_t *obj, bool down)
+            {
+                Ext *ext = (Ext *)lv_obj_get_ext_attr(obj);
+                if (ext->text == NULL)
+                {
+                    return false;
+                }
+
+                if (down)
+                {
+                    if (ext->ahead.size() == 0)
+                    {
+                        return false;
+                    }
+                    ext->layout = ext->ahead;
+                    ext->screen++;
+                    lay_ahead(obj, ext);
+                }
+                else
+                {
+                    if (ext->screen == 0)
+                    {
+                        return false;
+                    }
+                    // Screens before this one are laid out again, their starts are kept
+                    ext->ahead = ext->layout;
+                    ext->screen--;
+                    const ChordTable lines = ChordTable::get(ext->radius, ext->line_height);
+                    ext->layout.layout(TextSpan(ext->text, ext->len), glyphs_of(obj), lines, ext->screen_start[ext->screen]);
+                }
+
+                lv_obj_invalidate(obj);
+                return true;
+            };
+
+            /**
+             * Whether an object was made by create().
+             */
+            static bool is(const lv_obj_t *obj)
+            {
+                return obj != NULL && lv_obj_get_signal_cb(obj) == &RoundText::signal_cb;
+            };
+
+            /**
+             * Number of lines placed on the screen shown.
+             */
+            static uint8_t line_count(const lv_obj_t *obj)
+            {
+                return ((const Ext *)lv_obj_get_ext_attr(obj))->layout.size();
+            };
+
+        private:
+            static constexpr uint8_t MaxScreens = 16;
+            // Longest line drawn, a chord never holds more than this
+            static constexpr uint16_t LineMaxChars = 127;
+
+            struct Ext
+            {
+                char *text;
+                uint16_t len;
+                lv_coord_t radius;
+                lv_coord_t line_height;
+                uint8_t screen;
+                uint16_t screen_start[MaxScreens];
+                TextLayout layout;
+                TextLayout ahead;
+            };
+
+            static GlyphAdvance glyphs_of(lv_obj_t *obj)
+            {
+                lv_style_int_t letter_space = lv_obj_get_style_value_letter_space(obj, LV_LABEL_PART_MAIN);
+                const lv_font_t *font = lv_obj_get_style_value_font(obj, LV_LABEL_PART_MAIN);
+                return GlyphAdvance::get(font, letter_space);
+            };
+
+            // Lay out one screen of look-ahead after the one shown
+            static void lay_ahead(lv_obj_t *obj, Ext *ext)
+            {
+                uint16_t start = ext->layout.consumed();
+
+                // A word wider than every line makes no progress, stop there
+                if (ext->screen + 1 >= MaxScreens || start <= ext->screen_start[ext->screen])
+                {
+                    ext->ahead = TextLayout();
+                    return;
+                }
+
+                ext->screen_start[ext->screen + 1] = start;
+                const ChordTable lines = ChordTable::get(ext->radius, ext->line_height);
+                ext->ahead.layout(TextSpan(ext->text, ext->len), glyphs_of(obj), lines, start,
+                    ext->screen + 2 == MaxScreens);
+            };
+
+            static lv_design_res_t design_cb(lv_obj_t *obj, const lv_area_t *clip_area, lv_design_mode_t mode)
+            {
+                // Only the glyphs are drawn, whatever is behind shows through
+                if (mode == LV_DESIGN_COVER_CHK)
+                {
+                    return LV_DESIGN_RES_NOT_COVER;
+                }
+                if (mode != LV_DESIGN_DRAW_MAIN)
+                {
+                    return LV_DESIGN_RES_OK;
+                }
+
+                const Ext *ext = (const Ext *)lv_obj_get_ext_attr(obj);
+                if (ext->text == NULL)
+                {
+                    return LV_DESIGN_RES_OK;
+                }
+
+                lv_draw_label_dsc_t label_dsc;
+                lv_draw_label_dsc_init(&label_dsc);
+                lv_obj_init_draw_label_dsc(obj, LV_OBJ_PART_MAIN, &label_dsc);
+
+                const ChordTable lines = ChordTable::get(ext->radius, ext->line_height);
+                const Lines *chord = lines.begin();
+                lv_coord_t cx = obj->coords.x1 + ext->radius;
+
+                for (uint8_t i = 0; i < ext->layout.size() && chord != lines.end(); i++, chord++)
+                {
+                    const LineRecord &line = ext->layout[i];
+                    if (line.length == 0)
+                    {
+                        continue;
+                    }
+
+                    lv_coord_t y1 = obj->coords.y1 + ext->radius - chord->y;
+                    if (y1 > clip_area->y2)
+                    {
+                        // Lines only go down from here
+                        break;
+                    }
+
+                    // Only the part of the strip inside the chord may be touched
+                    lv_area_t chord_area;
+                    lv_area_set(&chord_area, cx - chord->max_length / 2, y1,
+                        cx + chord->max_length / 2, y1 + ext->line_height - 1);
+                    lv_area_t line_clip;
+                    if (!_lv_area_intersect(&line_clip, clip_area, &chord_area))
+                    {
+                        continue;
+                    }
+
+                    // Room to the end of the chord, so kerning differences can
+                    // never make lv_draw_label() wrap the line
+                    lv_area_t line_area;
+                    lv_area_set(&line_area, cx - line.width / 2, y1,
+                        LV_MATH_MAX(cx + chord->max_length / 2, cx - line.width / 2 + line.width - 1),
+                        y1 + ext->line_height - 1);
+
+                    char line_text[LineMaxChars + 4];
+                    uint16_t len = LV_MATH_MIN(line.length, LineMaxChars);
+                    memcpy(line_text, ext->text + line.offset, len);
+                    if (line.ellipsis)
+                    {
+                        memcpy(line_text + len, "...", 3);
+                        len += 3;
+                    }
+                    line_text[len] = '\0';
+                    lv_draw_label(&line_area, &line_clip, &label_dsc, line_text, NULL);
+                }
+
+                return LV_DESIGN_RES_OK;
+            };
+
+            static lv_res_t signal_cb(lv_obj_t *obj, lv_signal_t sign, void *param)
+            {
+                lv_res_t res = ancestor_signal()(obj, sign, param);
+                if (res != LV_RES_OK)
+                {
+                    return res;
+                }
+
+                if (sign == LV_SIGNAL_CLEANUP)
+                {
+                    Ext *ext = (Ext *)lv_obj_get_ext_attr(obj);
+                    if (ext->text)
+                    {
+                        lv_mem_free(ext->text);
+                        ext->text = NULL;
+                    }
+                }
+                return res;
+            };
+
+            // Signal callback of the base object, run first
+            static lv_signal_cb_t& ancestor_signal()
+            {
+                static lv_signal_cb_t cb = NULL;
+                return cb;
+            };
+        };
+    }
+}
+
+#endif /* __ROUND_TEXT_H__ */
@@ -0,0 +1,300 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __STYLE_REGISTRY_H__
+#define __STYLE_REGISTRY_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * The properties of a style, as a value that can be compared.
+         *
+         * Properties are kept sorted, so the same set built in any order gives
+         * an equal key. Setting a property again replaces its value.
+         */
+        class StyleKey
+        {
+        public:
+            static constexpr uint8_t MaxProps = 8;
+
+            StyleKey() : _count(0), _props() {};
+
+            StyleKey& set_int(lv_style_property_t prop, lv_style_int_t value, lv_state_t state = LV_STATE_DEFAULT)
+            {
+                return set(prop, state, Int, (uint32_t)(uint16_t)value);
+            };
+
+            StyleKey& set_color(lv_style_property_t prop, lv_color_t value, lv_state_t state = LV_STATE_DEFAULT)
+            {
+                return set(prop, state, Color, value.full);
+            };
+
+            StyleKey& set_opa(lv_style_property_t prop, lv_opa_t value, lv_state_t state = LV_STATE_DEFAULT)
+            {
+                return set(prop, state, Opa, value);
+            };
+
+            StyleKey& set_ptr(lv_style_property_t prop, const void *value, lv_state_t state = LV_STATE_DEFAULT)
+            {
+                return set(prop, state, Ptr, (uintptr_t)value);
+            };
+
+            bool operator==(const StyleKey &other) const
+            {
+                if (_count != other._count)
+                {
+                    return false;
+                }
+                for (uint8_t i = 0; i < _count; i++)
+                {
+                    if (_props[i].prop != other._props[i].prop || _props[i].value != other._props[i].value)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            /**
+             * Write the properties into an initialised style.
+             */
+            void build(lv_style_t *style) const
+            {
+                for (uint8_t i = 0; i < _count; i++)
+                {
+                    const Prop &p = _props[i];
+                    switch (p.kind)
+                    {
+                    case Int:
+                        _lv_style_set_int(style, p.prop, (lv_style_int_t)(int16_t)p.value);
+                        break;
+                    case Color:
+                        _lv_style_set_color(style, p.prop, color_of(p.value));
+                        break;
+                    case Opa:
+                        _lv_style_set_opa(style, p.prop, (lv_opa_t)p.value);
+                        break;
+                    case Ptr:
+                        _lv_style_set_ptr(style, p.prop, (const void *)p.value);
+                        break;
+                    }
+                }
+            };
+
+            /**
+             * Set the properties as local style of an object instead.
+             */
+            void apply_local(lv_obj_t *obj, uint8_t part) const
+            {
+                for (uint8_t i = 0; i < _count; i++)
+                {
+                    const Prop &p = _props[i];
+                    switch (p.kind)
+                    {
+                    case Int:
+                        _lv_obj_set_style_local_int(obj, part, p.prop, (lv_style_int_t)(int16_t)p.value);
+                        break;
+                    case Color:
+                        _lv_obj_set_style_local_color(obj, part, p.prop, color_of(p.value));
+                        break;
+                    case Opa:
+                        _lv_obj_set_style_local_opa(obj, part, p.prop, (lv_opa_t)p.value);
+                        break;
+                    case Ptr:
+                        _lv_obj_set_style_local_ptr(obj, part, p.prop, (const void *)p.value);
+                        break;
+                    }
+                }
+            };
+
+        private:
+            enum Kind : uint8_t {Int, Color, Opa, Ptr};
+
+            struct Prop
+            {
+                lv_style_property_t prop;
+                Kind kind;
+                uintptr_t value;
+            };
+
+            StyleKey& set(lv_style_property_t prop, lv_state_t state, Kind kind, uintptr_t value)
+            {
+                prop |= (lv_style_property_t)state << LV_STYLE_STATE_POS;
+
+                uint8_t i = 0;
+                while (i < _count && _props[i].prop < prop)
+                {
+                    i++;
+                }
+                if (i < _count && _props[i].prop == prop)
+                {
+                    _props[i].kind = kind;
+                    _props[i].value = value;
+                    return *this;
+                }
+                if (_count >= MaxProps)
+                {
+                    SEGGER_RTT_printf(0, "StyleKey: too many properties, 0x%x dropped\r\n", prop);
+                    return *this;
+                }
+
+                memmove(&_props[i + 1], &_props[i], (_count - i) * sizeof(Prop));
+                _props[i] = {prop, kind, value};
+                _count++;
+                return *this;
+            };
+
+            static lv_color_t color_of(uintptr_t value)
+            {
+                lv_color_t color;
+                color.full = value;
+                return color;
+            };
+
+            uint8_t _count;
+            Prop _props[MaxProps];
+        };
+
+        /**
+         * One shared lv_style_t for each distinct set of style properties.
+         *
+         * LVGL styles are referenced, not copied, by the objects they are added
+         * to, so a style must live as long as its objects and must not change
+         * under them. Styles handed out here are built once, never changed
+         * and never freed. Objects styled alike share one style and its
+         * property memory, objects styled differently never share.
+         *
+         * When every slot is taken the properties go into the object's local
+         * style instead, so the object still looks right.
+         */
+        class StyleRegistry
+        {
+        public:
+            static constexpr uint8_t MaxStyles = 16;
+
+            /**
+             * The style with exactly these properties, built on first use.
+             *
+             * @return NULL when the registry is full.
+             */
+            static lv_style_t* get(const StyleKey &key)
+            {
+                StyleRegistry &registry = instance();
+                uint32_t start = us_ticker_read();
+                lv_style_t *style = NULL;
+
+                for (uint8_t i = 0; i < registry._count; i++)
+                {
+                    if (registry._entries[i].key == key)
+                    {
+                        style = &registry._entries[i].style;
+                        registry._hits++;
+                        break;
+                    }
+                }
+
+                if (style == NULL && registry._count < MaxStyles)
+                {
+                    Entry &entry = registry._entries[registry._count++];
+                    entry.key = key;
+                    lv_style_init(&entry.style);
+                    key.build(&entry.style);
+                    style = &entry.style;
+                    registry._misses++;
+                }
+                else if (style == NULL)
+                {
+                    SEGGER_RTT_printf(0, "StyleRegistry: full, %d styles\r\n", MaxStyles);
+                }
+
+                registry._lookup_us += us_ticker_read() - start;
+                return style;
+            };
+
+            /**
+             * Add the style with these properties to an object's part.
+             */
+            static void add(lv_obj_t *obj, uint8_t part, const StyleKey &key)
+            {
+                lv_style_t *style = get(key);
+                if (style)
+                {
+                    lv_obj_add_style(obj, part, style);
+                }
+                else
+                {
+                    key.apply_local(obj, part);
+                }
+            };
+
+            static uint8_t count() { return instance()._count; };
+
+            /**
+             * LVGL memory held by the property lists of all styles.
+             */
+            static uint32_t style_bytes()
+            {
+                StyleRegistry &registry = instance();
+                uint32_t bytes = 0;
+                for (uint8_t i = 0; i < registry._count; i++)
+                {
+                    bytes += _lv_style_get_mem_size(&registry._entries[i].style);
+                }
+                return bytes;
+            };
+
+            static void report()
+            {
+                StyleRegistry &registry = instance();
+                uint32_t lookups = registry._hits + registry._misses;
+                SEGGER_RTT_printf(0, "styles: %u/%u, %u bytes, %u lookups, %u reused, %u us avg\r\n",
+                    registry._count, MaxStyles, style_bytes(), lookups, registry._hits,
+                    lookups ? registry._lookup_us / lookups : 0);
+            };
+
+        private:
+            struct Entry
+            {
+                StyleKey key;
+                lv_style_t style;
+            };
+
+            StyleRegistry() : _count(0), _hits(0), _misses(0), _lookup_us(0), _entries() {};
+
+            static StyleRegistry& instance()
+            {
+                static StyleRegistry registry;
+                return registry;
+            };
+
+            uint8_t _count;
+            uint32_t _hits;
+            uint32_t _misses;
+            uint32_t _lookup_us;
+            Entry _entries[MaxStyles];
+        };
+    }
+}
+
+#endif /* __STYLE_REGISTRY_H__ */
@@ -0,0 +1,246 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEXT_LAYOUT_H__
+#define __TEXT_LAYOUT_H__
+
+#include "mbed.h"
+#include "GlyphAdvance.h"
+#include "ChordTable.h"
+
+#include <array>
+#include <string.h>
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Read only view of characters that are not copied, like a string_view.
+         */
+        struct TextSpan
+        {
+            const char *data;
+            uint16_t len;
+
+            TextSpan(const char *text) : data(text), len(strlen(text)) {};
+            TextSpan(const char *text, uint16_t length) : data(text), len(length) {};
+
+            // A fixed size message buffer, e.g. Notification::message, up to its NUL
+            template<size_t N>
+            TextSpan(const std::array<char, N> &text) : data(text.data()), len(strnlen(text.data(), N)) {};
+        };
+
+        /**
+         * One laid out line, as a slice of the source text.
+         *
+         * An ellipsis line is drawn with "..." after the slice, width includes it.
+         */
+        struct LineRecord
+        {
+            uint16_t offset;
+            uint16_t length;
+            int16_t width;
+            bool ellipsis;
+        };
+
+        /**
+         * Word wraps text onto the lines of a ChordTable.
+         *
+         * Words are split on spaces and measured in place, the results are
+         * slices of the source text in a fixed array. Record i belongs to chord
+         * line i. A line too narrow for the next word is left empty, as before,
+         * unless the word is wider than every line. Such a word is cut between
+         * glyphs and carries on over the next lines.
+         *
+         * No glyph is measured more than a few times, words are only measured
+         * up to the widest line, so the work per screen is bounded by the
+         * number of lines however the text looks. Nothing is allocated.
+         *
+         * A NUL inside the span, e.g. in a message received over BLE, separates
+         * words like a space. Callers drawing a line must not pass it on.
+         *
+         * Text longer than the circle is laid out a screen at a time, each
+         * starting where the previous one's consumed() ends. With ellipsis the
+         * last line of a full screen ends in "..." instead.
+         */
+        class TextLayout
+        {
+        public:
+            static constexpr uint8_t MaxLines = ChordTable::MaxLines;
+
+            TextLayout() : _count(0), _consumed(0), _more(false), _lines() {};
+
+            /**
+             * Lay out text from start until it or the chord lines run out.
+             *
+             * @return the number of line records.
+             */
+            uint8_t layout(const TextSpan &text, const GlyphAdvance &glyphs, const ChordTable &lines,
+                uint16_t start = 0, bool ellipsis = false)
+            {
+                Word word;
+                bool more = next_word(text, start, glyphs, lines.widest(), word);
+
+                _count = 0;
+                _consumed = start;
+
+                for (const Lines *line = lines.begin(); line != lines.end() && more; line++)
+                {
+                    LineRecord &record = _lines[_count++];
+                    Word line_start = word;
+
+                    more = fill(record, text, glyphs, lines.widest(), line->max_length, word);
+                    if (ellipsis && more && line + 1 == lines.end())
+                    {
+                        // Circle is full, make room for the ellipsis on the last line
+                        lv_coord_t dots = ellipsis_width(glyphs);
+                        word = line_start;
+                        fill(record, text, glyphs, lines.widest(), line->max_length - dots, word);
+                        record.ellipsis = true;
+                        record.width += record.length ? dots : dots - glyphs.letter_space();
+                    }
+
+                    if (record.length)
+                    {
+                        _consumed = record.offset + record.length;
+                    }
+                }
+                _more = more;
+
+                return _count;
+            };
+
+            uint8_t size() const { return _count; };
+            const LineRecord& operator[](uint8_t i) const { return _lines[i]; };
+
+            /**
+             * Bytes of the text up to the end of the last word placed.
+             */
+            uint16_t consumed() const { return _consumed; };
+
+            /**
+             * Whether text was left over when the lines ran out.
+             */
+            bool more() const { return _more; };
+
+        private:
+            struct Word
+            {
+                uint16_t offset;
+                uint16_t len;
+                int16_t width;
+                uint32_t first;
+                uint32_t last;
+            };
+
+            /**
+             * Put words on one line, starting with word.
+             *
+             * @return false when the text ran out, otherwise word is the first
+             *         word of the next line.
+             */
+            static bool fill(LineRecord &record, const TextSpan &text, const GlyphAdvance &glyphs,
+                lv_coord_t widest, lv_coord_t max_length, Word &word)
+            {
+                record.offset = word.offset;
+                record.length = 0;
+                record.width = 0;
+                record.ellipsis = false;
+
+                int32_t width = 0;
+                uint16_t end = word.offset;
+                uint32_t last = 0;
+                bool more = true;
+
+                while (more)
+                {
+                    if (record.length == 0 && word.width > widest)
+                    {
+                        // Would never fit, take as much as this line holds and
+                        // carry the rest of the word over
+                        uint16_t bytes;
+                        width = glyphs.fit(text.data + word.offset, word.len, max_length, bytes, last);
+                        end = word.offset + bytes;
+                        record.length = end - record.offset;
+                        more = next_word(text, end, glyphs, widest, word);
+                        break;
+                    }
+
+                    int32_t test = word.width;
+                    if (record.length)
+                    {
+                        test += width + glyphs.join(last, word.first, word.offset - end);
+                    }
+                    if (test > max_length)
+                    {
+                        break;
+                    }
+
+                    width = test;
+                    end = word.offset + word.len;
+                    last = word.last;
+                    record.length = end - record.offset;
+                    more = next_word(text, end, glyphs, widest, word);
+                }
+
+                record.width = width;
+                return more;
+            };
+
+            static lv_coord_t ellipsis_width(const GlyphAdvance &glyphs)
+            {
+                uint32_t first;
+                uint32_t last;
+                return glyphs.word("...", 3, first, last) + glyphs.letter_space();
+            };
+
+            static bool is_space(char c)
+            {
+                return c == ' ' || c == '\0';
+            };
+
+            static bool next_word(const TextSpan &text, uint16_t pos, const GlyphAdvance &glyphs, lv_coord_t widest, Word &word)
+            {
+                while (pos < text.len && is_space(text.data[pos]))
+                {
+                    pos++;
+                }
+                if (pos >= text.len)
+                {
+                    return false;
+                }
+
+                uint16_t end = pos;
+                while (end < text.len && !is_space(text.data[end]))
+                {
+                    end++;
+                }
+
+                word.offset = pos;
+                word.len = end - pos;
+                // Anything past the widest line is cut anyway, stop measuring there
+                word.width = glyphs.word(text.data + pos, word.len, word.first, word.last, widest);
+                return true;
+            };
+
+            uint8_t _count;
+            uint16_t _consumed;
+            bool _more;
+            LineRecord _lines[MaxLines];
+        };
+    }
+}
+
+#endif /* __TEXT_LAYOUT_H__ */
@@ -0,0 +1,138 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEXT_LAYOUT_BENCHMARK_H__
+#define __TEXT_LAYOUT_BENCHMARK_H__
+
+#include "mbed.h"
+#include "GlyphAdvance.h"
+#include "ChordTable.h"
+#include "TextLayout.h"
+#include "RoundText.h"
+#include "TextLayoutCorpus.h"
+
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Timing and memory of the round text layout on the watch itself.
+         *
+         * Runs the TextLayoutCorpus texts through the layout for each font and
+         * diameter and prints one line per case over RTT:
+         *
+         *   - chord: building the ChordTable, measured once per key
+         *   - layout: average TextLayout::layout() time for the first screen
+         *   - heap: malloc calls made during the layout, needs a build with
+         *     MBED_HEAP_STATS_ENABLED, -1 otherwise
+         *   - pool: LVGL memory taken by a RoundText showing the text
+         *
+         * Call after lv_init() and lv_disp_drv_register(), from the thread that
+         * runs LVGL.
+         */
+        class TextLayoutBenchmark
+        {
+        public:
+            static void run()
+            {
+                static const lv_font_t * const fonts[] = {&lv_font_montserrat_14, &lv_font_montserrat_36};
+                static const uint8_t font_sizes[] = {14, 36};
+                static const lv_coord_t diameters[] = {150, 200, 240};
+
+                SEGGER_RTT_printf(0, "text layout benchmark: %d runs per case\r\n", Runs);
+
+                for (uint8_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++)
+                {
+                    const GlyphAdvance glyphs = GlyphAdvance::get(fonts[f], 0);
+
+                    for (uint8_t d = 0; d < sizeof(diameters) / sizeof(diameters[0]); d++)
+                    {
+                        uint32_t start = us_ticker_read();
+                        ChordTable::get(diameters[d] / 2, glyphs.line_height());
+                        uint32_t chord_us = us_ticker_read() - start;
+
+                        for (uint8_t t = 0; t < TextLayoutCorpus::Size; t++)
+                        {
+                            run_case(TextLayoutCorpus::name(t), TextLayoutCorpus::text(t), fonts[f], font_sizes[f],
+                                diameters[d], glyphs, chord_us);
+                            chord_us = 0;
+                        }
+                    }
+                }
+
+                SEGGER_RTT_printf(0, "text layout benchmark: done\r\n");
+            };
+
+        private:
+            static constexpr uint8_t Runs = 10;
+
+            static void run_case(const char *name, const char *text, const lv_font_t *font, uint8_t font_size,
+                lv_coord_t diameter, const GlyphAdvance &glyphs, uint32_t chord_us)
+            {
+                TextLayout layout;
+                TextSpan span(text);
+                const ChordTable lines = ChordTable::get(diameter / 2, glyphs.line_height());
+                uint8_t line_count = lines.size();
+
+                int32_t allocs = heap_allocs();
+                uint32_t start = us_ticker_read();
+                for (uint8_t i = 0; i < Runs; i++)
+                {
+                    layout.layout(span, glyphs, lines);
+                }
+                uint32_t layout_us = (us_ticker_read() - start) / Runs;
+                if (allocs >= 0)
+                {
+                    allocs = heap_allocs() - allocs;
+                }
+
+                lv_mem_monitor_t mem_before;
+                lv_mem_monitor(&mem_before);
+                lv_obj_t *obj = RoundText::create(lv_scr_act(), diameter, "");
+                lv_obj_set_style_local_text_font(obj, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, font);
+                RoundText::set_text(obj, span);
+                lv_mem_monitor_t mem_after;
+                lv_mem_monitor(&mem_after);
+                lv_obj_del(obj);
+
+                int32_t pool = (int32_t)(mem_after.total_size - mem_after.free_size) -
+                    (int32_t)(mem_before.total_size - mem_before.free_size);
+
+                SEGGER_RTT_printf(0, "%s m%d d%d: chord=%u us layout=%u us lines=%d/%d more=%d heap=%d pool=%d B\r\n",
+                    name, font_size, diameter, chord_us, layout_us, layout.size(), line_count, layout.more(),
+                    allocs, pool);
+            };
+
+            // malloc calls so far, -1 when mbed keeps no heap statistics
+            static int32_t heap_allocs()
+            {
+#if MBED_HEAP_STATS_ENABLED
+                mbed_stats_heap_t stats;
+                mbed_stats_heap_get(&stats);
+                return stats.alloc_cnt;
+#else
+                return -1;
+#endif
+            };
+        };
+    }
+}
+
+#endif /* __TEXT_LAYOUT_BENCHMARK_H__ */
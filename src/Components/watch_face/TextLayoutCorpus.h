@@ -0,0 +1,64 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEXT_LAYOUT_CORPUS_H__
+#define __TEXT_LAYOUT_CORPUS_H__
+
+#include <stdint.h>
+
+namespace Mytime {
+    namespace Windows {
+        /**
+         * Notification texts the round text layout is measured with, on the
+         * watch by TextLayoutBenchmark and on the host by the test benchmark.
+         *
+         * Short and typical messages, and adversarial ones: a word wider than
+         * the circle, runs of spaces, many tiny words and multi-byte UTF-8.
+         */
+        struct TextLayoutCorpus
+        {
+            static constexpr uint8_t Size = 8;
+
+            static const char* name(uint8_t i)
+            {
+                static const char * const names[Size] = {
+                    "short", "typical", "long", "url", "token", "spaces", "tiny words", "utf8"
+                };
+                return names[i];
+            };
+
+            static const char* text(uint8_t i)
+            {
+                static const char * const texts[Size] = {
+                    "OK",
+                    "Running late, be there in 10 minutes. Can you order me a coffee?",
+                    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut "
+                    "labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris "
+                    "nisi ut aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit "
+                    "esse cillum dolore eu fugiat nulla pariatur.",
+                    "Reset link: https://accounts.example.com/recover/7f3a9c0e5b1d4a8f9e2c6b0d3a7f1e5c?session=4b8d2f",
+                    "WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW",
+                    "a                                                                                              b",
+                    "a b c d e f g h i j k l m n o p q r s t u v w x y z a b c d e f g h i j k l m n o p q r s t u v w",
+                    "Caf\xC3\xA9 \xC3\xA0 16h, r\xC3\xA9union d\xC3\xA9plac\xC3\xA9" "e \xC3\xA0 la salle \xC3\xA9t\xC3\xA9"
+                };
+                return texts[i];
+            };
+        };
+    }
+}
+
+#endif /* __TEXT_LAYOUT_CORPUS_H__ */
@@ -0,0 +1,499 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TICK_TIMER_SERVICE_H__
+#define __TICK_TIMER_SERVICE_H__
+
+#include "mbed.h"
+#include "RenderScheduler.h"
+#include "UiCommandQueue.h"
+
+#include <time.h>
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+extern events::EventQueue app_queue;
+
+namespace Mytime {
+    namespace Windows {
+
+// Bits, a subscription or a tick can name several units at once
+enum TimeUnits {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+    MONTH_UNIT = 1 << 4,
+    YEAR_UNIT = 1 << 5
+};
+
+inline TimeUnits operator|(TimeUnits a, TimeUnits b)
+{
+    return (TimeUnits)((int)a | (int)b);
+};
+
+        /**
+         * Calls handlers when the wall clock crosses a second, minute, hour,
+         * day, month or year boundary.
+         *
+         * Every subscriber shares one event on app_queue, timed for the next
+         * boundary of the finest unit anyone asked for. On waking the time is
+         * compared with the last wake, and each handler whose units changed is
+         * called in the render context with the full units_changed mask. A
+         * unit changing means every finer unit changed with it.
+         *
+         * time() only counts whole seconds, so where within the second it
+         * ticks over is learned by polling around a boundary, once at the
+         * start, after time_set() and again every hour in case it drifted.
+         * Between those a boundary costs one wakeup.
+         */
+        class TickTimerService
+        {
+        public:
+            typedef mbed::Callback<void(struct tm *, TimeUnits)> Handler;
+
+            static constexpr uint8_t MaxSubscribers = 4;
+
+            /**
+             * Call handler on every change of any of units. Subscribing a
+             * handler again replaces its units.
+             *
+             * @return false when every slot is taken.
+             */
+            static bool subscribe(TimeUnits units, Handler handler)
+            {
+                TickTimerService &service = instance();
+                Subscriber *slot = nullptr;
+                {
+                    CriticalSectionLock lock;
+                    for (uint8_t i = 0; i < MaxSubscribers; i++)
+                    {
+                        Subscriber &s = service._subscribers[i];
+                        if (s.units && s.handler == handler)
+                        {
+                            slot = &s;
+                            break;
+                        }
+                        if (s.units == 0 && slot == nullptr)
+                        {
+                            slot = &s;
+                        }
+                    }
+                    if (slot)
+                    {
+                        slot->handler = handler;
+                        slot->units = units;
+                    }
+                }
+
+                if (slot == nullptr)
+                {
+                    SEGGER_RTT_printf(0, "TickTimerService: full, %d subscribers\r\n", MaxSubscribers);
+                    return false;
+                }
+                reschedule();
+                return true;
+            };
+
+            static void unsubscribe(Handler handler)
+            {
+                TickTimerService &service = instance();
+                {
+                    CriticalSectionLock lock;
+                    for (uint8_t i = 0; i < MaxSubscribers; i++)
+                    {
+                        Subscriber &s = service._subscribers[i];
+                        if (s.units && s.handler == handler)
+                        {
+                            s.units = 0;
+                            s.handler = nullptr;
+                        }
+                    }
+                }
+                reschedule();
+            };
+
+            static void unsubscribe_all()
+            {
+                TickTimerService &service = instance();
+                {
+                    CriticalSectionLock lock;
+                    for (uint8_t i = 0; i < MaxSubscribers; i++)
+                    {
+                        service._subscribers[i].units = 0;
+                        service._subscribers[i].handler = nullptr;
+                    }
+                }
+                reschedule();
+            };
+
+            /**
+             * Units that changed between two times, finer units included.
+             */
+            static uint32_t units_changed(const struct tm &from, const struct tm &to)
+            {
+                uint32_t changed = 0;
+                if (from.tm_year != to.tm_year)
+                {
+                    changed |= YEAR_UNIT;
+                }
+                if (changed || from.tm_mon != to.tm_mon)
+                {
+                    changed |= MONTH_UNIT;
+                }
+                if (changed || from.tm_mday != to.tm_mday)
+                {
+                    changed |= DAY_UNIT;
+                }
+                if (changed || from.tm_hour != to.tm_hour)
+                {
+                    changed |= HOUR_UNIT;
+                }
+                if (changed || from.tm_min != to.tm_min)
+                {
+                    changed |= MINUTE_UNIT;
+                }
+                if (changed || from.tm_sec != to.tm_sec)
+                {
+                    changed |= SECOND_UNIT;
+                }
+                return changed;
+            };
+
+            /**
+             * Call after set_time(). Handlers see the new time straight away
+             * and where the second ticks over is learned again.
+             *
+             * Safe from any thread.
+             */
+            static void time_set()
+            {
+                if (app_queue.call(mbed::callback(&TickTimerService::clock_changed)) == 0)
+                {
+                    SEGGER_RTT_printf(0, "TickTimerService: app_queue full\r\n");
+                }
+            };
+
+            /**
+             * Wakeups since start up, and in the last full hour.
+             */
+            static uint32_t wakeups() { return instance()._wakeups_total; };
+            static uint32_t wakeups_last_hour() { return instance()._wakeups_last_hour; };
+
+            static void report()
+            {
+                TickTimerService &service = instance();
+                SEGGER_RTT_printf(0, "ticks: %u subscribers, %u delivered, %u wakeups, %u wakeups last hour\r\n",
+                    service.subscriber_count(), service._delivered, service._wakeups_total, service._wakeups_last_hour);
+            };
+
+        private:
+            // Poll step while waiting for time() to tick over
+            static constexpr int32_t PollMs = 10;
+            // Aim past the learned phase by this much
+            static constexpr int32_t MarginMs = 2;
+            // How early to aim when checking the phase again
+            static constexpr int32_t GuardMs = 50;
+            static constexpr uint32_t RelearnMs = 3600000;
+            // Longest sleep, a clock set forward is noticed within this
+            static constexpr uint32_t MaxSleepS = 3600;
+
+            struct Subscriber
+            {
+                Handler handler;
+                uint32_t units;
+            };
+
+            TickTimerService() :
+                _subscribers(),
+                _event(0),
+                _started(false),
+                _last(),
+                _target(0),
+                _phase_known(false),
+                _phase_ms(0),
+                _polling(false),
+                _relearn(false),
+                _pending(0),
+                _delivered(0),
+                _wakeups_total(0),
+                _wakeups(0),
+                _wakeups_last_hour(0),
+                _window_start(0) {};
+
+            static TickTimerService& instance()
+            {
+                static TickTimerService service;
+                return service;
+            };
+
+            static uint32_t now_ms()
+            {
+                return (uint32_t)rtos::Kernel::get_ms_count();
+            };
+
+            // The wakeup belongs to app_queue alone, changes are handed over to it
+            static void reschedule()
+            {
+                if (app_queue.call(mbed::callback(&TickTimerService::schedule)) == 0)
+                {
+                    SEGGER_RTT_printf(0, "TickTimerService: app_queue full\r\n");
+                }
+            };
+
+            uint32_t subscribed_units() const
+            {
+                CriticalSectionLock lock;
+                uint32_t units = 0;
+                for (uint8_t i = 0; i < MaxSubscribers; i++)
+                {
+                    units |= _subscribers[i].units;
+                }
+                return units;
+            };
+
+            uint8_t subscriber_count() const
+            {
+                CriticalSectionLock lock;
+                uint8_t count = 0;
+                for (uint8_t i = 0; i < MaxSubscribers; i++)
+                {
+                    count += _subscribers[i].units ? 1 : 0;
+                }
+                return count;
+            };
+
+            // Whole seconds from now to the next boundary of the finest unit
+            static uint32_t seconds_to_boundary(const struct tm &now, uint32_t units)
+            {
+                uint32_t finest = units & (~units + 1);
+                int32_t seconds;
+                switch (finest)
+                {
+                case SECOND_UNIT:
+                    seconds = 1;
+                    break;
+                case MINUTE_UNIT:
+                    seconds = 60 - now.tm_sec;
+                    break;
+                case HOUR_UNIT:
+                    seconds = 3600 - (now.tm_min * 60 + now.tm_sec);
+                    break;
+                default:
+                    // Months and years also start at midnight
+                    seconds = 86400 - (now.tm_hour * 3600 + now.tm_min * 60 + now.tm_sec);
+                    break;
+                }
+                return LV_MATH_MIN((uint32_t)LV_MATH_MAX(seconds, 1), MaxSleepS);
+            };
+
+            // Runs on app_queue
+            static void schedule()
+            {
+                TickTimerService &service = instance();
+                if (service._event)
+                {
+                    app_queue.cancel(service._event);
+                    service._event = 0;
+                }
+
+                uint32_t units = service.subscribed_units();
+                if (units == 0)
+                {
+                    service._started = false;
+                    service._polling = false;
+                    return;
+                }
+
+                time_t now = time(NULL);
+                struct tm now_tm;
+                localtime_r(&now, &now_tm);
+                uint32_t ms = now_ms();
+                if (!service._started)
+                {
+                    // Changes are counted from the first subscription on
+                    service._last = now_tm;
+                    service._started = true;
+                    service._window_start = ms;
+                }
+
+                uint32_t seconds = seconds_to_boundary(now_tm, units);
+                service._target = now + seconds;
+                service._polling = false;
+
+                int32_t delay;
+                if (!service._phase_known)
+                {
+                    // The second ticks over somewhere in the last second before
+                    // the target, wake at its start and poll for it
+                    delay = (seconds - 1) * 1000 + 1;
+                }
+                else
+                {
+                    uint32_t since = ms - service._phase_ms;
+                    delay = seconds * 1000 - since % 1000 + MarginMs;
+                    service._relearn = since >= RelearnMs;
+                    if (service._relearn)
+                    {
+                        delay -= GuardMs;
+                    }
+                }
+
+                service._event = app_queue.call_in(LV_MATH_MAX(delay, 1), mbed::callback(&TickTimerService::wake));
+            };
+
+            // Runs on app_queue
+            static void wake()
+            {
+                TickTimerService &service = instance();
+                service._event = 0;
+                service.count_wakeup();
+
+                time_t now = time(NULL);
+                if (now < service._target - 1)
+                {
+                    // The clock was set back, show it and start over from there
+                    service._phase_known = false;
+                    service.update(now);
+                    schedule();
+                    return;
+                }
+                if (now < service._target)
+                {
+                    // Early, time() has not ticked over yet
+                    service._polling = true;
+                    service._event = app_queue.call_in(PollMs, mbed::callback(&TickTimerService::wake));
+                    return;
+                }
+
+                if (service._polling)
+                {
+                    // It ticked over during the last poll step
+                    service._phase_ms = now_ms() - PollMs / 2;
+                    service._phase_known = true;
+                }
+                else if (service._relearn)
+                {
+                    // Aimed early and still late, the phase moved, find it again
+                    service._phase_known = false;
+                }
+                service._relearn = false;
+
+                service.update(now);
+                schedule();
+            };
+
+            // Runs on app_queue
+            static void clock_changed()
+            {
+                TickTimerService &service = instance();
+                service._phase_known = false;
+                if (service._started)
+                {
+                    service.update(time(NULL));
+                }
+                schedule();
+            };
+
+            // Hands the units changed since the last update to the handlers
+            void update(time_t now)
+            {
+                struct tm now_tm;
+                localtime_r(&now, &now_tm);
+                uint32_t changed = units_changed(_last, now_tm);
+                _last = now_tm;
+
+                if (changed & subscribed_units())
+                {
+                    // Kept until delivered, a full UI queue only delays it
+                    core_util_atomic_fetch_or_u32(&_pending, changed);
+                    Mytime::Controllers::UiCommandQueue::post(mbed::callback(&TickTimerService::deliver));
+                }
+            };
+
+            // Runs in the render context, handlers change LVGL objects
+            static void deliver()
+            {
+                TickTimerService &service = instance();
+                uint32_t changed = core_util_atomic_exchange_u32(&service._pending, 0);
+                if (changed == 0)
+                {
+                    return;
+                }
+
+                Subscriber subscribers[MaxSubscribers];
+                {
+                    CriticalSectionLock lock;
+                    for (uint8_t i = 0; i < MaxSubscribers; i++)
+                    {
+                        subscribers[i] = service._subscribers[i];
+                    }
+                }
+
+                time_t now = time(NULL);
+                struct tm now_tm;
+                localtime_r(&now, &now_tm);
+
+                for (uint8_t i = 0; i < MaxSubscribers; i++)
+                {
+                    // Unsubscribed after the tick was posted is skipped here
+                    if (subscribers[i].units & changed)
+                    {
+                        subscribers[i].handler(&now_tm, (TimeUnits)changed);
+                        service._delivered++;
+                    }
+                }
+
+                // The handlers usually changed a label, get it drawn
+                Mytime::Controllers::RenderScheduler::kick();
+            };
+
+            void count_wakeup()
+            {
+                uint32_t ms = now_ms();
+                if (ms - _window_start >= 3600000)
+                {
+                    _wakeups_last_hour = _wakeups;
+                    _wakeups = 0;
+                    _window_start = ms;
+                }
+                _wakeups++;
+                _wakeups_total++;
+            };
+
+            Subscriber _subscribers[MaxSubscribers];
+            int _event;
+            bool _started;
+            struct tm _last;
+            time_t _target;
+            bool _phase_known;
+            uint32_t _phase_ms;
+            bool _polling;
+            bool _relearn;
+            volatile uint32_t _pending;
+            uint32_t _delivered;
+            uint32_t _wakeups_total;
+            uint32_t _wakeups;
+            uint32_t _wakeups_last_hour;
+            uint32_t _window_start;
+        };
+    }
+}
+
+#endif /* __TICK_TIMER_SERVICE_H__ */
@@ -49,11 +49,26 @@ static void main_window_load(Mytime::Windows::Window* w)
     // SEGGER_RTT_printf(0, "**mwl X\n\r");
 }
 
+static void update_time();
+static void tick_handler(struct tm *tick_time, Mytime::Windows::TimeUnits units_changed);
+
+static void main_window_appear()
+{
+    // The window may have been hidden for a while, catch up before it is drawn
+    update_time();
+}
+
+static void main_window_disappear()
+{
+    // No ticks while hidden, the window stays loaded for next time
+    tick_timer_service_unsubscribe(&tick_handler);
+}
+
 static void main_window_unload(/*Window *window*/)
 {
     // SEGGER_RTT_printf(0, "**mwu E\n\r");
     // Unsubscribe from timer/Ticker service
-    tick_timer_service_unsubscribe();
+    tick_timer_service_unsubscribe(&tick_handler);
 
     // SEGGER_RTT_printf(0, "**mwu X\n\r");
 }
@@ -98,15 +113,21 @@ namespace Mytime {
             {
                 // SEGGER_RTT_printf(0, "**wi E\r\n");
 
-                s_main_window = window_create();
-
-                window_set_window_handlers(s_main_window, (Mytime::Windows::WindowHandlers)
+                // Created once, pushing it again shows the layers kept from last time
+                if (s_main_window == nullptr)
                 {
-                    .load = mbed::callback(&main_window_load),
-                    .unload = mbed::callback(&main_window_unload)
-                });
+                    s_main_window = window_create();
+
+                    window_set_window_handlers(s_main_window, (Mytime::Windows::WindowHandlers)
+                    {
+                        .load = mbed::callback(&main_window_load),
+                        .appear = mbed::callback(&main_window_appear),
+                        .disappear = mbed::callback(&main_window_disappear),
+                        .unload = mbed::callback(&main_window_unload)
+                    });
+                }
 
-                window_stack_push(s_main_window);
+                window_stack_push(s_main_window, true);
 
                 // Register with TickTimerService
                 tick_timer_service_subscribe(Mytime::Windows::MINUTE_UNIT, &tick_handler);
@@ -117,22 +138,11 @@ namespace Mytime {
             void deinit()
             {
                 // SEGGER_RTT_printf(0, "**wdi E\r\n");
+                // Hidden, not destroyed, so coming back is a single redraw
                 window_stack_pop(false);
-                window_destroy(s_main_window);
                 // SEGGER_RTT_printf(0, "**wdi X\r\n");
             };
 
-            void main()
-            {
-                // SEGGER_RTT_printf(0, "***************wm E\r\n");                 
-
-                init();
-                app_queue.dispatch_forever();
-                deinit();
-
-                // SEGGER_RTT_printf(0, "***************wm X\r\n");                 
-            };
-
         // private:
             // events::EventQueue& _event_queue;
         };
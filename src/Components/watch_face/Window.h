@@ -19,6 +19,16 @@
 
 #include "mbed.h"
 #include "Api.h"
+#include "RenderScheduler.h"
+#include "UiCommandQueue.h"
+#include "ScrollTransition.h"
+#include "GlyphAdvance.h"
+#include "ChordTable.h"
+#include "TextLayout.h"
+#include "RoundText.h"
+#include "StyleRegistry.h"
+#include "TickTimerService.h"
+#include "WindowPool.h"
 
 #include <map>
 #include <vector>
@@ -33,6 +43,13 @@ extern "C"{
 #define GFont lv_font_t
 #define GColor lv_color_t
 
+// 1 draws round text from a single RoundText object, 0 from a label per line
+#define ROUND_TEXT_WIDGET 1
+// Set to 1 to print the time and LVGL memory used to lay out round text
+#define TEXT_LAYOUT_MONITOR 0
+// Hidden windows are unloaded, oldest first, while more of the LVGL pool is in use
+#define WINDOW_CACHE_MAX_USED_PCT 75
+
 extern events::EventQueue app_queue;
 
 typedef struct {
@@ -66,72 +83,203 @@ private:
     lv_area_t _area;
 };
 
-/**
-WindowHandler load
-Called when the window is pushed to the screen when it's not loaded. This is a good moment to do the layout of the window.
-
-WindowHandler appear
-Called when the window comes on the screen (again). E.g. when second-top-most window gets revealed (again) after popping the top-most window, but also when the window is pushed for the first time. This is a good moment to start timers related to the window, or reset the UI, etc.
-
-WindowHandler disappear
-Called when the window leaves the screen, e.g. when another window is pushed, or this window is popped. Good moment to stop timers related to the window.
-
-WindowHandler unload
-Called when the window is deinited, but could be used in the future to free resources bound to windows that are not on screen.
-**/
-
 namespace Mytime {
     namespace Windows {
 
-enum TimeUnits {
-    SECOND_UNIT = 1000,
-    MINUTE_UNIT = 60000,
-    HOUR_UNIT = 36000,
-    DAY_UNIT,
-    MONTH_UNIT,
-    YEAR_UNIT
-};
-
-class Window;
-
-typedef struct {
-    mbed::Callback<void(Mytime::Windows::Window*)> load{nullptr};
-    mbed::Callback<void(void)> appear{nullptr};
-    mbed::Callback<void(void)> disappear{nullptr};
-    mbed::Callback<void(void)> unload{nullptr};
-} WindowHandlers;
-
         /**
+         * The windows pushed, top one shown, and windows popped but kept.
+         *
+         * A window stays loaded after it is covered or popped, only its root
+         * object is hidden. Pushing it again calls appear and shows it, which
+         * costs one redraw instead of building its layers again. Popped windows
+         * are unloaded, oldest first, once the LVGL pool runs low.
          */
-        class Window
+        class WindowStack
         {
         public:
-            ~Window() {};
-            Window(lv_obj_t* w) : _window(w) {};
-            void setHandlers(WindowHandlers handlers)
+            static constexpr uint8_t Size = WindowPool::Size;
+
+            /**
+             * Put a window on top, moving it up if it is already on the stack.
+             */
+            static void push(Window *w)
             {
-                _handlers = handlers;
+                WindowStack &stack = instance();
+                if (w == top())
+                {
+                    return;
+                }
+
+                remove(stack._stack, stack._count, w);
+                remove(stack._cached, stack._cached_count, w);
+
+                if (stack._count == Size)
+                {
+                    SEGGER_RTT_printf(0, "WindowStack: full, %d windows\r\n", Size);
+                    return;
+                }
+
+                if (top())
+                {
+                    hide(top());
+                }
+                stack._stack[stack._count++] = w;
+
+                if (!w->isLoaded())
+                {
+                    // Make room before building the new window's layers
+                    trim();
+                    WindowHandlers &handlers = w->getHandlers();
+                    if (handlers.load)
+                    {
+                        handlers.load(w);
+                    }
+                    w->setLoaded(true);
+                }
+                show(w);
             };
 
-            WindowHandlers& getHandlers()
+            /**
+             * Take the top window off and show the one under it.
+             *
+             * @return the window popped, still loaded.
+             */
+            static Window* pop()
             {
-                return _handlers;
+                WindowStack &stack = instance();
+                Window *w = top();
+                if (w == nullptr)
+                {
+                    return nullptr;
+                }
+
+                hide(w);
+                stack._count--;
+                stack._cached[stack._cached_count++] = w;
+
+                if (top())
+                {
+                    show(top());
+                }
+                trim();
+                return w;
             };
 
-            lv_obj_t *getWindow() { return _window; };
+            static Window* top()
+            {
+                WindowStack &stack = instance();
+                return stack._count ? stack._stack[stack._count - 1] : nullptr;
+            };
+
+            /**
+             * Unload a window if needed and forget it, before it is destroyed.
+             */
+            static void forget(Window *w)
+            {
+                WindowStack &stack = instance();
+                if (w == top())
+                {
+                    pop();
+                }
+                remove(stack._stack, stack._count, w);
+                remove(stack._cached, stack._cached_count, w);
+                unload(w);
+            };
+
+            static uint8_t cached() { return instance()._cached_count; };
 
         private:
-            WindowHandlers _handlers;
-            lv_obj_t * _window;
+            WindowStack() : _stack(), _count(0), _cached(), _cached_count(0) {};
+
+            static WindowStack& instance()
+            {
+                static WindowStack stack;
+                return stack;
+            };
+
+            static void show(Window *w)
+            {
+                lv_obj_set_hidden(w->getWindow(), false);
+                WindowHandlers &handlers = w->getHandlers();
+                if (handlers.appear)
+                {
+                    handlers.appear();
+                }
+            };
+
+            static void hide(Window *w)
+            {
+                WindowHandlers &handlers = w->getHandlers();
+                if (handlers.disappear)
+                {
+                    handlers.disappear();
+                }
+                lv_obj_set_hidden(w->getWindow(), true);
+            };
+
+            // Delete what load built, the root object itself is kept
+            static void unload(Window *w)
+            {
+                if (!w->isLoaded())
+                {
+                    return;
+                }
+                WindowHandlers &handlers = w->getHandlers();
+                if (handlers.unload)
+                {
+                    handlers.unload();
+                }
+                lv_obj_clean(w->getWindow());
+                w->setLoaded(false);
+            };
+
+            static void trim()
+            {
+                WindowStack &stack = instance();
+                while (stack._cached_count)
+                {
+                    lv_mem_monitor_t mon;
+                    lv_mem_monitor(&mon);
+                    if (mon.used_pct < WINDOW_CACHE_MAX_USED_PCT)
+                    {
+                        break;
+                    }
+                    Window *oldest = stack._cached[0];
+                    remove(stack._cached, stack._cached_count, oldest);
+                    unload(oldest);
+                    SEGGER_RTT_printf(0, "WindowStack: LVGL pool %d%% used, hidden window unloaded\r\n", mon.used_pct);
+                }
+            };
+
+            static void remove(Window **windows, uint8_t &count, Window *w)
+            {
+                for (uint8_t i = 0; i < count; i++)
+                {
+                    if (windows[i] == w)
+                    {
+                        memmove(&windows[i], &windows[i + 1], (count - i - 1) * sizeof(Window *));
+                        count--;
+                        return;
+                    }
+                }
+            };
+
+            Window *_stack[Size];
+            uint8_t _count;
+            // Popped and still loaded, oldest first
+            Window *_cached[Size];
+            uint8_t _cached_count;
         };
     }
 }
 
-std::array<Mytime::Windows::Window*, 100> windows_array;
-
 void window_set_window_handlers(Mytime::Windows::Window* w, Mytime::Windows::WindowHandlers handlers)
 {
     SEGGER_RTT_printf(0, "wswh E\r\n");                 
+    if (w == nullptr)
+    {
+        return;
+    }
     w->setHandlers(handlers);
     SEGGER_RTT_printf(0, "wswh X\r\n");                 
 }
@@ -149,144 +297,49 @@ Mytime::Windows::Window* window_create()
     lv_obj_align(obj, NULL, LV_ALIGN_CENTER, 0, 0);
 
     // Fill base rectangle with white
-    static lv_style_t style_background;
-    lv_style_set_bg_color(&style_background, LV_STATE_DEFAULT, LV_COLOR_WHITE);
+    Mytime::Windows::StyleRegistry::add(obj, LV_OBJ_PART_MAIN,
+        Mytime::Windows::StyleKey().set_color(LV_STYLE_BG_COLOR, LV_COLOR_WHITE));
     // lv_style_set_border_width(&style_background, LV_STATE_DEFAULT, 1);
     // lv_style_set_border_color(&style_background, LV_STATE_DEFAULT, LV_COLOR_BLACK);
 
-    Mytime::Windows::Window* w = new Mytime::Windows::Window(obj);
+    Mytime::Windows::Window* w = Mytime::Windows::WindowPool::acquire(obj);
+    if (w == nullptr)
+    {
+        lv_obj_del(obj);
+    }
 
     SEGGER_RTT_printf(0, "wc X\r\n");
     return w;
 }
 
+// Delete the window's root object, and with it every layer created on the
+// window, then return the window to the pool
 void window_destroy(Mytime::Windows::Window* w)
 {
-    lv_obj_clean(w->getWindow());    
-}
-
-typedef struct
-{
-    int16_t y;
-    int16_t max_length;
-} Lines;
-
-std::vector<Lines>lines_array;
-
-// std::map<int16_t, int16_t>lines_map;
-
-void initLines(int16_t r, int16_t line_height, std::vector<Lines>& lines)
-{
-    for (int16_t y = r; y > -r; y -= line_height)
+    if (w == nullptr)
     {
-        int16_t h = LV_MATH_ABS(r - y);
-// SEGGER_RTT_printf(0, "h=%d\r\n", h);               
-        // if (y - line_height < 0)
-        // {
-        //     h += 20;
-        // }
-
-        int16_t length = (int16_t)(2 * sqrt(h * (2 * r - h)));
-
-        if (length && length > 10)
-        {
-SEGGER_RTT_printf(0, "y=%d length=%d\r\n", y, length);
-            lines.push_back({y, length});
-        }
+        return;
     }
-}
-
-const std::vector<std::string> explode(const std::string& s, const char& c)
-{
-	std::string buff{""};
-	std::vector<string> v;
-	
-	for(auto n:s)
-	{
-		if(n != c) buff+=n; else
-		if(n == c && buff != "") { v.push_back(buff); buff = ""; }
-	}
-	if(buff != "") v.push_back(buff);
-	
-	return v;
-}
 
-typedef struct 
-{
-    int16_t count;
-    int16_t width;
-    int16_t text_height;
-    std::string text;
-} WordData;
-
-void calcAllowableWords(WordData& word_data, lv_obj_t * obj, int16_t maxWidth, std::vector<std::string>& words)
-{
-    int16_t wordCount = 0;
-    std::string testLine = "";
-    std::string spacer = "";
-    int16_t fittedWidth = 0;
-    std::string fittedText = "";
-    lv_point_t txt_size = {0};
+    Mytime::Windows::WindowStack::forget(w);
 
-    // ctx.font = font;
-
-    for (int16_t i = 0; i < words.size(); i++)
+    if (w->getWindow())
     {
-        testLine += spacer + words[i];
-        spacer = " ";
-
-        // The the width of the text
-        lv_style_int_t letter_space = lv_obj_get_style_value_letter_space(obj, LV_LABEL_PART_MAIN);
-        lv_style_int_t line_space = lv_obj_get_style_value_letter_space(obj, LV_LABEL_PART_MAIN);
-        const lv_font_t * font = lv_obj_get_style_value_font(obj, LV_LABEL_PART_MAIN);
-
-        _lv_txt_get_size(&txt_size, testLine.c_str(), font, letter_space, line_space, LV_COORD_MAX, LV_TXT_FLAG_NONE);
-// SEGGER_RTT_printf(0, "txt_size.x=%d,txt_size.y=%d\r\n", txt_size.x, txt_size.y);
-
-
-        // var width = ctx.measureText(testLine).width;
-
-        if (txt_size.x > maxWidth)
-        {
-            word_data.count = i;
-            word_data.width = fittedWidth;
-            word_data.text = fittedText;
-            word_data.text_height = txt_size.y;
-// SEGGER_RTT_printf(0, "word_data.count=%d,word_data.width=%d,word_data.text=%s\r\n", word_data.count, word_data.width, word_data.text.c_str());
-            return;
-        }
-
-        fittedWidth = txt_size.x;
-        fittedText = testLine;
+        lv_obj_del(w->getWindow());
     }
-
-    word_data.count = words.size();
-    word_data.width = txt_size.x;
-    word_data.text = testLine;
-    word_data.text_height = txt_size.y;
-// SEGGER_RTT_printf(0, "word_data.count=%d,word_data.width=%d,word_data.text=%s\r\n", word_data.count, word_data.width, word_data.text.c_str());
+    Mytime::Windows::WindowPool::release(w);
+    Mytime::Controllers::RenderScheduler::kick();
 }
 
-void wrapText(lv_obj_t * obj, char* text)
+// Longest line handed to a label, anything past it is cut off
+#define WRAP_LINE_MAX_CHARS 127
+
+void wrapText(lv_obj_t * obj, const Mytime::Windows::TextSpan& text)
 {
-//   char str[] ="- This, a sample string.";
-//   char * pch;
-//   SEGGER_RTT_printf(0, "Splitting string \"%s\" into tokens:\n",text);
-//   pch = strtok (text," ,.-");
-//   while (pch != NULL)
-//   {
-//     SEGGER_RTT_printf(0, "%s\n",pch);
-//     pch = strtok (NULL, " ,.-");
-//   }
-
-    std::vector<std::string> words{explode(std::string(text), ' ')};
-// 	for(auto n:words)
-//     {
-// SEGGER_RTT_printf(0, "token=%s\r\n", n.c_str());
-//     }
-
-    int16_t i = 0;
-   
+    lv_style_int_t letter_space = lv_obj_get_style_value_letter_space(obj, LV_LABEL_PART_MAIN);
+    const lv_font_t * font = lv_obj_get_style_value_font(obj, LV_LABEL_PART_MAIN);
+    const Mytime::Windows::GlyphAdvance glyphs = Mytime::Windows::GlyphAdvance::get(font, letter_space);
+
     // Get page Y position and padding
     lv_area_t page_coords;
     lv_obj_get_coords(obj, &page_coords);
@@ -304,18 +357,20 @@ SEGGER_RTT_printf(0, "page_coords.x1=%d,y1=%d,x2=%d,y2=%d\r\n", page_coords.x1,
     int16_t cx = pagew / 2;
 SEGGER_RTT_printf(0, "cx=%d\r\n", cx);
 
-    auto it = lines_array.begin();
-    while (it != lines_array.end() && words.size() > 0)
+    // Chord widths for the page's circle, built once per size and font
+    const Mytime::Windows::ChordTable lines = Mytime::Windows::ChordTable::get(pagew / 2, glyphs.line_height());
+
+    // Line slices of the text, no copies until each is handed to its label
+    Mytime::Windows::TextLayout layout;
+    layout.layout(text, glyphs, lines, 0, true);
+
+    const Lines *it = lines.begin();
+    for (uint8_t i = 0; i < layout.size(); i++, it++)
     {
+        const Mytime::Windows::LineRecord& line = layout[i];
         int16_t line_y = it->y;
-        int16_t lines_max_length = it->max_length;
-SEGGER_RTT_printf(0, "line_y=%d, lines_max_length=%d\r\n", line_y, lines_max_length);
-
-        WordData line_data;
-        calcAllowableWords(line_data, obj, lines_max_length, words);
+SEGGER_RTT_printf(0, "line_y=%d, lines_max_length=%d\r\n", line_y, it->max_length);
 
-        static lv_style_t style_label;
-        lv_style_init(&style_label);
         // Make the padding/margin really small
         // lv_style_set_pad_left(&style_label, LV_STATE_DEFAULT, 10);
         // lv_style_set_pad_top(&style_label, LV_STATE_DEFAULT, 10);
@@ -330,28 +385,32 @@ SEGGER_RTT_printf(0, "line_y=%d, lines_max_length=%d\r\n", line_y, lines_max_len
         // lv_label_set_long_mode(label, LV_LABEL_LONG_BREAK);            /*Automatically break long lines*/
         lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
 
-        lv_obj_set_width(label, line_data.width);
+        lv_obj_set_width(label, line.width);
 
-        int16_t xpos = cx - (line_data.width / 2);
-// SEGGER_RTT_printf(0, "xpos=%d\r\n", xpos);
-// SEGGER_RTT_printf(0, "wtop-line_y=%d\r\n", wtop - line_y);
-// SEGGER_RTT_printf(0, "wtop-line_y+line_data.text_height=%d\r\n", wtop - line_y + line_data.text_height);
-        int16_t ypos = wtop - line_y + line_data.text_height;
-SEGGER_RTT_printf(0, "xpos=%d,ypos=%d,wid=%d,text=%s\r\n", xpos, ypos, line_data.width, line_data.text.c_str());
+        int16_t xpos = cx - (line.width / 2);
+        int16_t ypos = wtop - line_y + glyphs.line_height();
         lv_obj_set_pos(label, xpos, ypos);
 
-// SEGGER_RTT_printf(0, "line_data.count=%d, .width=%d, .text_height=%d, .text=%s\r\n", line_data.count, line_data.width, line_data.text_height, line_data.text.c_str());
-// SEGGER_RTT_printf(0, "line_y=%d, ypos=%d\r\n", line_y, ypos);
+        // The label keeps its own copy of the text
+        char line_text[WRAP_LINE_MAX_CHARS + 4];
+        uint16_t len = LV_MATH_MIN(line.length, WRAP_LINE_MAX_CHARS);
+        for (uint16_t c = 0; c < len; c++)
+        {
+            // The layout splits words on NUL too, the label must not stop there
+            line_text[c] = text.data[line.offset + c] ? text.data[line.offset + c] : ' ';
+        }
+        if (line.ellipsis)
+        {
+            memcpy(line_text + len, "...", 3);
+            len += 3;
+        }
+        line_text[len] = '\0';
+SEGGER_RTT_printf(0, "xpos=%d,ypos=%d,wid=%d,text=%s\r\n", xpos, ypos, line.width, line_text);
 
-        lv_label_set_text(label, line_data.text.c_str());
+        lv_label_set_text(label, line_text);
         // lv_style_set_border_width(&style_label, LV_STATE_DEFAULT, 1);
-        lv_obj_add_style(label, LV_OBJ_PART_MAIN, &style_label);
 
     //     ctx.fillText(lineData.text, cx - lineData.width / 2, cy - line.y + textHeight);
-
-        // Remove the words already used
-        words.erase(words.begin(), words.begin() + line_data.count);
-        it++;
     }
 }
 
@@ -406,42 +465,34 @@ TextLayer* text_layer_create(Mytime::Windows::Window *parent_window, GRect &rect
     // lv_obj_set_width(label, rect.width());
     // lv_obj_set_height(label, rect.height());
 
-    static lv_style_t style_background;
-    lv_style_init(&style_background);
-    lv_style_set_border_width(&style_background, LV_STATE_DEFAULT, 2);
+    Mytime::Windows::StyleKey style_background;
+    style_background.set_int(LV_STYLE_BORDER_WIDTH, 2);
 
-    lv_style_set_radius(&style_background, LV_STATE_DEFAULT, LV_RADIUS_CIRCLE); // Make round
+    style_background.set_int(LV_STYLE_RADIUS, LV_RADIUS_CIRCLE); // Make round
 
-    /*Create a page*/
-    lv_obj_t * page = lv_page_create(lv_scr_act(), NULL);
+    /*Create a page, on the window so it goes when the window is destroyed*/
+    lv_obj_t * page = lv_page_create(parent_window->getWindow(), NULL);
     // lv_obj_set_width(page, 150);
     lv_obj_set_size(page, 150, 150);
     lv_obj_align(page, NULL, LV_ALIGN_CENTER, 0, 0);
     lv_page_set_scrlbar_mode(page, LV_SCRLBAR_MODE_OFF);
 
     // Make the padding/margin really small
-    lv_style_set_pad_left(&style_background, LV_STATE_DEFAULT, 1);
-    lv_style_set_pad_top(&style_background, LV_STATE_DEFAULT, 1);
-    lv_style_set_pad_right(&style_background, LV_STATE_DEFAULT, 1);
-    lv_style_set_pad_bottom(&style_background, LV_STATE_DEFAULT, 1);
+    style_background.set_int(LV_STYLE_PAD_LEFT, 1);
+    style_background.set_int(LV_STYLE_PAD_TOP, 1);
+    style_background.set_int(LV_STYLE_PAD_RIGHT, 1);
+    style_background.set_int(LV_STYLE_PAD_BOTTOM, 1);
 
     // lv_style_set_margin_top(&style_background, LV_STATE_DEFAULT, 1);
 
-    lv_obj_add_style(page, LV_OBJ_PART_MAIN, &style_background);
+    Mytime::Windows::StyleRegistry::add(page, LV_OBJ_PART_MAIN, style_background);
 
     // Now have a round page now figure out labels to fill the round window
-    lv_coord_t diam = lv_obj_get_width(page);
-    const lv_font_t * font = lv_obj_get_style_value_font(page, LV_LABEL_PART_MAIN);
-    initLines(diam / 2, font->line_height, lines_array);
     // wrapText(page, "'Twas the night before Christmas, when all through the house,  Not a creature was stirring, not even a mouse.  And so begins the story of the day of Christmas");
-    wrapText(page, "Lorem ipsum dolor sit amet, consectetur adipiscing elit,"
-                             "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua."
-                             "Ut enim ad minim veniam, quis nostrud exercitation ullamco"
-                             "laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure"
-                             "dolor in reprehenderit in voluptate velit esse cillum dolore"
-                             "eu fugiat nulla pariatur."
-                             "Excepteur sint occaecat cupidatat non proident, sunt in culpa"
-                             "qui officia deserunt mollit anim id est laborum.");
+#if ROUND_TEXT_WIDGET
+    // Text is filled in by text_layer_set_round_text()
+    Mytime::Windows::RoundText::create(page, lv_obj_get_width(page), "");
+#endif
 
 
 
@@ -482,34 +533,90 @@ TextLayer* text_layer_create(Mytime::Windows::Window *parent_window, GRect &rect
 void window_stack_push(Mytime::Windows::Window* w, bool animate = false)
 {
     SEGGER_RTT_printf(0, "window_stack_push START\r\n");                 
-    // Push to the top of the stack and call the load handlers
-    windows_array[0] = w;
-    Mytime::Windows::WindowHandlers handlers = w->getHandlers();
-    if (handlers.load)
+    if (w == nullptr)
+    {
+        return;
+    }
+    // Push to the top of the stack, load it unless it was kept and call appear
+    Mytime::Windows::WindowStack::push(w);
+    if (animate)
     {
-        handlers.load(w);
+        // New window comes in from the bottom, only its revealed rows are sent
+        Mytime::Controllers::ScrollTransition::slide(Mytime::Controllers::ScrollTransition::Up);
     }
+    Mytime::Controllers::RenderScheduler::kick();
     SEGGER_RTT_printf(0, "window_stack_push EXIT\r\n");                 
 }
 
 Mytime::Windows::Window* window_stack_pop(bool animated)
 {
     // SEGGER_RTT_printf(0, "stack_pop START\r\n");
-    // Pop off and call handlers    
-    // Mytime::Windows::Window* w = nullptr;
-    Mytime::Windows::Window* w = windows_array[0];
+    // Pop off and call disappear, the window is hidden but stays loaded
+    Mytime::Windows::Window* w = Mytime::Windows::WindowStack::pop();
     // SEGGER_RTT_printf(0, "window_stack_pop w=%0x%x\r\n", w);
-    Mytime::Windows::WindowHandlers handlers = w->getHandlers();
-    // SEGGER_RTT_printf(0, "window_stack_pop handlers=%0x%x\r\n", handlers);
-    // SEGGER_RTT_printf(0, "window_stack_pop handlers.unload=%0x%x\r\n", handlers.unload);
-    if (handlers.unload)
+    if (w && animated)
     {
-        handlers.unload();
+        // Window underneath comes back in from the top
+        Mytime::Controllers::ScrollTransition::slide(Mytime::Controllers::ScrollTransition::Down);
     }
+    Mytime::Controllers::RenderScheduler::kick();
     // SEGGER_RTT_printf(0, "stack_pop EXIT\r\n");
     return w;
 }
 
+// Word wrap text into the circle of a text layer. Give the notification id for
+// a message that may be shown again, its layout is then kept and reused.
+void text_layer_set_round_text(TextLayer *tl, const Mytime::Windows::TextSpan& text,
+    uint32_t id = Mytime::Windows::LayoutCache::NoId)
+{
+#if TEXT_LAYOUT_MONITOR
+    lv_mem_monitor_t mem_before;
+    lv_mem_monitor(&mem_before);
+    uint32_t layout_start = lv_tick_get();
+#endif
+
+#if ROUND_TEXT_WIDGET
+    lv_obj_t *round_text = lv_obj_get_child(lv_page_get_scrollable(tl), NULL);
+    if (Mytime::Windows::RoundText::is(round_text))
+    {
+        Mytime::Windows::RoundText::set_text(round_text, text, id);
+    }
+#else
+    lv_page_clean(tl);
+    wrapText(tl, text);
+#endif
+
+#if TEXT_LAYOUT_MONITOR
+    // Refresh time for the page shows up in the display monitor output
+    lv_mem_monitor_t mem_after;
+    lv_mem_monitor(&mem_after);
+    SEGGER_RTT_printf(0, "text layout: widget=%d, %u ms, %d bytes LVGL memory, cache %u%% hits, %u us saved\r\n",
+        ROUND_TEXT_WIDGET, lv_tick_elaps(layout_start),
+        (int)(mem_after.total_size - mem_after.free_size) - (int)(mem_before.total_size - mem_before.free_size),
+        Mytime::Windows::LayoutCache::hit_rate(), Mytime::Windows::LayoutCache::time_saved_us());
+#endif
+    Mytime::Controllers::RenderScheduler::kick();
+}
+
+// Show the next or previous screen of a text layer's round text. Returns false
+// when there is no more text that way.
+bool text_layer_scroll(TextLayer *tl, bool down)
+{
+    bool moved = false;
+#if ROUND_TEXT_WIDGET
+    lv_obj_t *round_text = lv_obj_get_child(lv_page_get_scrollable(tl), NULL);
+    if (Mytime::Windows::RoundText::is(round_text))
+    {
+        moved = Mytime::Windows::RoundText::scroll(round_text, down);
+    }
+#endif
+    if (moved)
+    {
+        Mytime::Controllers::RenderScheduler::kick();
+    }
+    return moved;
+}
+
 void text_layer_set_long_mode(TextLayer *tl, lv_label_long_mode_t mode)
 {
     lv_label_set_long_mode(tl, mode);
@@ -529,21 +636,14 @@ void text_layer_set_text_alignment(TextLayer *tl, const lv_label_align_t align)
 void text_layer_set_background_color(TextLayer *tl, lv_color_t color)
 {
     // Fill base rectangle with yellow
-    static lv_style_t style_background;
-    lv_style_init(&style_background);
-
-    lv_style_set_bg_color(&style_background, LV_STATE_DEFAULT, color);
-    lv_obj_add_style(tl, LV_OBJ_PART_MAIN, &style_background);
+    Mytime::Windows::StyleRegistry::add(tl, LV_OBJ_PART_MAIN,
+        Mytime::Windows::StyleKey().set_color(LV_STYLE_BG_COLOR, color));
 }
 
 void text_layer_set_text_color(TextLayer *tl, lv_color_t color)
 {
-    // Fill base rectangle with yellow
-    static lv_style_t style_text_color;
-    lv_style_init(&style_text_color);
-
-    lv_style_set_text_color(&style_text_color, LV_STATE_DEFAULT, color);
-    lv_obj_add_style(tl, LV_OBJ_PART_MAIN, &style_text_color);
+    Mytime::Windows::StyleRegistry::add(tl, LV_OBJ_PART_MAIN,
+        Mytime::Windows::StyleKey().set_color(LV_STYLE_TEXT_COLOR, color));
 }
 
 void text_layer_set_text(TextLayer *tl, const char *txt)
@@ -553,11 +653,8 @@ void text_layer_set_text(TextLayer *tl, const char *txt)
 
 void text_layer_set_font(TextLayer *tl, const lv_font_t *fnt)
 {
-    static lv_style_t style_set_font;
-    lv_style_init(&style_set_font);
-
-    lv_style_set_text_font(&style_set_font, LV_STATE_DEFAULT, fnt);
-    lv_obj_add_style(tl, LV_OBJ_PART_MAIN, &style_set_font);
+    Mytime::Windows::StyleRegistry::add(tl, LV_OBJ_PART_MAIN,
+        Mytime::Windows::StyleKey().set_ptr(LV_STYLE_TEXT_FONT, fnt));
 }
 
 void text_layer_set_alignment(TextLayer *tl, lv_align_t align)
@@ -567,41 +664,21 @@ void text_layer_set_alignment(TextLayer *tl, lv_align_t align)
 
 // extern events::EventQueue event_queue;
 
-static int tick_instance = -1;
-
-void intermediate_ticker(mbed::Callback<void(struct tm *, Mytime::Windows::TimeUnits)> handler, Mytime::Windows::TimeUnits time_unit)
+void tick_timer_service_unsubscribe(mbed::Callback<void(struct tm *, Mytime::Windows::TimeUnits)> handler)
 {
-    SEGGER_RTT_printf(0, "it E\r\n");
-    time_t seconds = time(NULL);
-    struct tm *current_time;
-    current_time = localtime(&seconds);
-
-    handler(current_time, time_unit);
-    SEGGER_RTT_printf(0, "it X\r\n");
+    Mytime::Windows::TickTimerService::unsubscribe(handler);
 }
 
+// Drops every subscriber, prefer passing the handler
 void tick_timer_service_unsubscribe(void)
 {
-    SEGGER_RTT_printf(0, "ttsu E\r\n");
-    if (tick_instance != -1)
-    {
-        app_queue.cancel(tick_instance);
-        tick_instance = -1;
-    }
-    SEGGER_RTT_printf(0, "ttsu X\r\n");
+    Mytime::Windows::TickTimerService::unsubscribe_all();
 }
 
+// Handlers run in the render context on each boundary of any of the units
 void tick_timer_service_subscribe(Mytime::Windows::TimeUnits time_unit, mbed::Callback<void(struct tm *, Mytime::Windows::TimeUnits)> handler)
 {
-    SEGGER_RTT_printf(0, "ttss E\n\r");
-    // TODO - think need an array to tick_instances so we can 
-    if (tick_instance != -1)
-    {
-        tick_timer_service_unsubscribe();
-    }
-
-    tick_instance = app_queue.call_every(time_unit, mbed::callback(&intermediate_ticker), handler, time_unit);
-    SEGGER_RTT_printf(0, "ttss X\n\r");
+    Mytime::Windows::TickTimerService::subscribe(time_unit, handler);
 }
 
 GFont* fonts_load_custom_font(const char *file_path)
@@ -625,20 +702,17 @@ GContext* graphics_draw_circle(GContext* ctx, GPoint p, uint16_t radius)
     lv_obj_set_pos(s_background_obj, p.x, p.y); // Position off screen
 
     // Fill base rectangle with TEAL
-    static lv_style_t style_background;
-    lv_style_init(&style_background);
-    lv_style_set_border_width(&style_background, LV_STATE_DEFAULT, 9);
-    lv_style_set_radius(&style_background, LV_STATE_DEFAULT, LV_RADIUS_CIRCLE); // Make round
-    lv_obj_add_style(s_background_obj, LV_OBJ_PART_MAIN, &style_background);
+    Mytime::Windows::StyleKey style_background;
+    style_background.set_int(LV_STYLE_BORDER_WIDTH, 9);
+    style_background.set_int(LV_STYLE_RADIUS, LV_RADIUS_CIRCLE); // Make round
+    Mytime::Windows::StyleRegistry::add(s_background_obj, LV_OBJ_PART_MAIN, style_background);
 
     return s_background_obj;
 }
 
 void window_set_background_color(GContext* ctx, GColor background_color)
 {
-    static lv_style_t style_background;
-    lv_style_init(&style_background);
-    lv_style_set_bg_color(&style_background, LV_STATE_DEFAULT, background_color);
-    lv_obj_add_style(ctx, LV_OBJ_PART_MAIN, &style_background);
+    Mytime::Windows::StyleRegistry::add(ctx, LV_OBJ_PART_MAIN,
+        Mytime::Windows::StyleKey().set_color(LV_STYLE_BG_COLOR, background_color));
 }
 #endif /* __WINDOW_API_H__ */
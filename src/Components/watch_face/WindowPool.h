@@ -0,0 +1,159 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WINDOW_POOL_H__
+#define __WINDOW_POOL_H__
+
+#include "mbed.h"
+
+#include <lvgl/lvgl.h>
+
+extern "C"{
+  #include "SEGGER_RTT.h"
+}
+
+/**
+WindowHandler load
+Called when the window is pushed to the screen when it's not loaded. This is a good moment to do the layout of the window.
+
+WindowHandler appear
+Called when the window comes on the screen (again). E.g. when second-top-most window gets revealed (again) after popping the top-most window, but also when the window is pushed for the first time. This is a good moment to start timers related to the window, or reset the UI, etc.
+
+WindowHandler disappear
+Called when the window leaves the screen, e.g. when another window is pushed, or this window is popped. Good moment to stop timers related to the window.
+
+WindowHandler unload
+Called when the window is deinited, but could be used in the future to free resources bound to windows that are not on screen.
+**/
+
+namespace Mytime {
+    namespace Windows {
+
+class Window;
+
+typedef struct {
+    mbed::Callback<void(Mytime::Windows::Window*)> load{nullptr};
+    mbed::Callback<void(void)> appear{nullptr};
+    mbed::Callback<void(void)> disappear{nullptr};
+    mbed::Callback<void(void)> unload{nullptr};
+} WindowHandlers;
+
+        /**
+         */
+        class Window
+        {
+        public:
+            ~Window() {};
+            Window(lv_obj_t* w = nullptr) : _window(w), _loaded(false) {};
+            void setHandlers(WindowHandlers handlers)
+            {
+                _handlers = handlers;
+            };
+
+            WindowHandlers& getHandlers()
+            {
+                return _handlers;
+            };
+
+            lv_obj_t *getWindow() { return _window; };
+
+            // Whether load ran and unload has not since
+            bool isLoaded() { return _loaded; };
+            void setLoaded(bool loaded) { _loaded = loaded; };
+
+        private:
+            WindowHandlers _handlers;
+            lv_obj_t * _window;
+            bool _loaded;
+        };
+
+        /**
+         * Fixed set of Window objects, handed out by window_create() and
+         * returned by window_destroy().
+         *
+         * Only one app shows a window at a time, so a few slots are enough and
+         * switching apps never touches the heap.
+         */
+        class WindowPool
+        {
+        public:
+            static constexpr uint8_t Size = 4;
+
+            /**
+             * A free window for an LVGL root object.
+             *
+             * @return nullptr when every window is in use.
+             */
+            static Window* acquire(lv_obj_t *root)
+            {
+                WindowPool &pool = instance();
+                for (uint8_t i = 0; i < Size; i++)
+                {
+                    if (!pool._used[i])
+                    {
+                        pool._used[i] = true;
+                        pool._windows[i] = Window(root);
+                        return &pool._windows[i];
+                    }
+                }
+                SEGGER_RTT_printf(0, "WindowPool: all %d windows in use\r\n", Size);
+                return nullptr;
+            };
+
+            /**
+             * Give a window back, its root object must already be deleted.
+             */
+            static void release(Window *w)
+            {
+                WindowPool &pool = instance();
+                for (uint8_t i = 0; i < Size; i++)
+                {
+                    if (&pool._windows[i] == w)
+                    {
+                        pool._windows[i] = Window();
+                        pool._used[i] = false;
+                        return;
+                    }
+                }
+            };
+
+            static uint8_t in_use()
+            {
+                WindowPool &pool = instance();
+                uint8_t count = 0;
+                for (uint8_t i = 0; i < Size; i++)
+                {
+                    count += pool._used[i];
+                }
+                return count;
+            };
+
+        private:
+            WindowPool() : _windows(), _used() {};
+
+            static WindowPool& instance()
+            {
+                static WindowPool pool;
+                return pool;
+            };
+
+            Window _windows[Size];
+            bool _used[Size];
+        };
+    }
+}
+
+#endif /* __WINDOW_POOL_H__ */
@@ -2,6 +2,12 @@
 #include <mbed.h>
 #include "lv_drv_conf.h"
 #include "common.h"
+#if GC9A01_BUS_MONITOR
+#include "PanelMonitor.h"
+#endif
+#if GC9A01_SPI_BITS == 9
+#include "Spi9Packer.h"
+#endif
 // #include "BMA42X-Sensor-Driver/src/bma4_defs.h"
 
 #if 0
@@ -37,13 +43,47 @@ SPI spi(P1_15, NC, P1_13, P1_11); // MDBT50Q-DB board
 # endif
 #endif
 #if GC9A01_SPI_BITS == 9
+# if GC9A01_SPI9_BITBANG
 DigitalOut spi_mosi(SPI_PSELMOSI0);
 DigitalOut spi_sck(SPI_PSELSCK0);
+# elif GC9A01_SPI_EXT_CS
+SPI spi(SPI_PSELMOSI0, NC, SPI_PSELSCK0, NC);
+# else
+SPI spi(SPI_PSELMOSI0, NC, SPI_PSELSCK0, SPI_PSELSS0);
+# endif
 #endif
 #if GC9A01_SPI_EXT_CS
 DigitalOut spi_cs(SPI_PSELSS0);
 #endif
 
+#if GC9A01_SPI_BITS == 9 && !GC9A01_SPI9_BITBANG
+static Mytime::Controllers::Spi9Packer spi9;
+
+static void spi9_send()
+{
+	if (spi9.bytes() == 0) {
+		return;
+	}
+
+	spi.write((const char *)spi9.data(), spi9.bytes(), NULL, 0);
+# if GC9A01_SPI_EXT_CS
+	// Pulse chip select so the padding bits are not taken as the next word
+	int cs = spi_cs;
+	spi_cs = 1;
+	spi_cs = cs;
+# endif
+
+	spi9.clear();
+}
+
+static void spi9_put(uint8_t dc, uint8_t data)
+{
+	if (spi9.put(dc, data)) {
+		spi9_send();
+	}
+}
+#endif
+
 // BMA423 Accelerator
 I2C i2c(P0_26, P0_5);
 
@@ -65,27 +105,28 @@ void spi_cs_set(int val) {
 // a single byte so we just write it as a 32 bits integer
 void spi_wr(int data)
 {
+#if GC9A01_BUS_MONITOR
+	uint8_t byte = data;
+	if (cmd_data) Mytime::Controllers::PanelMonitor::data(&byte, 1);
+	else          Mytime::Controllers::PanelMonitor::command(byte);
+#endif
 #if GC9A01_SPI_BITS == 8
 	spi.write(data);
 #endif
-#if GC9A01_SPI_BITS == 9
-	spi_sck = 0; // Clock low
-	if (cmd_data) spi_mosi = 1;
-	else				  spi_mosi = 0;
-	spi_sck = 1; // Clock high
-
-	// Fast SPI bitbang
-	for(uint8_t bit = 0x80; bit; bit >>= 1) {
-		spi_sck = 0;
-		if (data & bit) spi_mosi = 1;
-		else            spi_mosi = 0;
-		spi_sck = 1;
-	}
+#if GC9A01_SPI_BITS == 9 && !GC9A01_SPI9_BITBANG
+	spi9_put(cmd_data, data);
+	spi9_send();
+#endif
+#if GC9A01_SPI_BITS == 9 && GC9A01_SPI9_BITBANG
+	Mytime::Controllers::Spi9Packer::bitbang(spi_sck, spi_mosi, cmd_data, data);
 #endif
 }
 
 void spi_wr_mem(char *addr, int len)
 {
+#if GC9A01_BUS_MONITOR && !(GC9A01_SPI_BITS == 9 && GC9A01_SPI9_BITBANG) // bit-bang counts in spi_wr()
+	Mytime::Controllers::PanelMonitor::data((const uint8_t *)addr, len);
+#endif
 #if GC9A01_SPI_BITS == 8
 	// uint8_t *ptr = (uint8_t *)addr;
 	// for (uint32_t i = 0; i < len; i++) {
@@ -98,10 +139,47 @@ void spi_wr_mem(char *addr, int len)
 #if GC9A01_SPI_BITS == 9
 	cmd_data = 1; // Set to data
 	uint8_t *ptr = (uint8_t *)addr;
+# if GC9A01_SPI9_BITBANG
 	for (uint32_t i = 0; i < len; i++) {
 		spi_wr(*ptr);
 		ptr++;
 	}
+# else
+	for (uint32_t i = 0; i < len; i++) {
+		spi9_put(1, *ptr);
+		ptr++;
+	}
+	spi9_send();
+# endif
+#endif
+}
+
+#if GC9A01_SPI_BITS == 8 && GC9A01_FLUSH_ASYNC && DEVICE_SPI_ASYNCH
+static void (*spi_async_done)(void) = NULL;
+
+// Called from the SPI interrupt once EasyDMA has clocked out the whole buffer
+static void spi_async_event(int event)
+{
+	if (spi_async_done) {
+		spi_async_done();
+	}
+}
+#endif
+
+// Start writing a buffer without waiting for the bus. The buffer must stay
+// untouched until 'done' is called. Without async SPI support the bytes are
+// written straight away and 'done' is called before returning.
+void spi_wr_mem_async(char *addr, int len, void (*done)(void))
+{
+#if GC9A01_SPI_BITS == 8 && GC9A01_FLUSH_ASYNC && DEVICE_SPI_ASYNCH
+# if GC9A01_BUS_MONITOR
+	Mytime::Controllers::PanelMonitor::data((const uint8_t *)addr, len);
+# endif
+	spi_async_done = done;
+	spi.transfer((const char *)addr, len, (char *)NULL, 0, mbed::callback(&spi_async_event), SPI_EVENT_COMPLETE);
+#else
+	spi_wr_mem(addr, len);
+	done();
 #endif
 }
 
@@ -118,11 +196,15 @@ void spi_mode(int bits, int mode)
 #if GC9A01_SPI_BITS == 8
 	spi.format(bits, mode);
 #endif
+#if GC9A01_SPI_BITS == 9 && !GC9A01_SPI9_BITBANG
+	// Words are packed into bytes so the hardware always runs 8 bit frames
+	spi.format(8, mode);
+#endif
 }
  
 void spi_set_freq(int val)
 {
-#if GC9A01_SPI_BITS == 8
+#if GC9A01_SPI_BITS == 8 || (GC9A01_SPI_BITS == 9 && !GC9A01_SPI9_BITBANG)
 	spi.frequency(val);
 #endif
 }
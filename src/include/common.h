@@ -11,6 +11,7 @@ void pin_cmd_set(int); // set cmd dta pin to a value
 void spi_cs_set(int); // setting chip select pin to a value
 void spi_wr(int); // write a byte over spi
 void spi_wr_mem(char *, int);
+void spi_wr_mem_async(char *, int, void (*)(void)); // write bytes in the background, callback runs in interrupt context when done
 void spi_set_freq(int); // set baudrate
 void spi_mode(int, int);
 void delay_ms(int);
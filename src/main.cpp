@@ -26,43 +26,92 @@
 #include "Components/ble/AlertNotificationService.h"
 #include "Components/ble/NotificationManager.h"
 #include "Components/datetime/DateTimeController.h"
+#include "Components/display/DisplayFlush.h"
+#include "Components/display/RoundPanel.h"
+#include "Components/display/AreaCoalescer.h"
+#include "Components/display/FillAccelerator.h"
+#include "Components/display/PanelMonitor.h"
+#include "Components/display/RenderScheduler.h"
+#include "Components/display/DisplayPowerManager.h"
+#include "Components/display/UiCommandQueue.h"
+#include "Components/display/ScrollTransition.h"
+#include "Components/app/AppExecutor.h"
 
 #include <lvgl/lvgl.h>
 #include <lv_drivers/display/GC9A01.h>
 #include <bma423_main.h>
 #include "WatchAPI.h"
 #include "NotificationDisplay.h"
+#include "TextLayoutBenchmark.h"
 
 extern "C"{
   #include "SEGGER_RTT.h"
 }
 
+#if !LV_TICK_CUSTOM
 #define LVGL_TICK 5
 // 5 milliseconds (5000 microseconds)
 #define TICKER_TIME 1000 * LVGL_TICK
+#endif
 
 events::EventQueue app_queue;
 events::EventQueue* queue = mbed_event_queue();
 
-Thread* t = nullptr;
-
 Mytime::Controllers::WatchAPI watchFace;
 Mytime::Controllers::NotificationDisplay notificationDisplay;
 
+// Apps run one at a time in the render context, their timers on a thread dispatching app_queue
+Mytime::Controllers::AppExecutor app_executor(app_queue);
+Mytime::Controllers::AppExecutor::App watch_app = {
+    "watch",
+    callback(&watchFace, &Mytime::Controllers::WatchAPI::init),
+    callback(&watchFace, &Mytime::Controllers::WatchAPI::deinit)
+};
+Mytime::Controllers::AppExecutor::App notification_app = {
+    "notification",
+    callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::init),
+    callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::deinit)
+};
+
 BLE &ble_interface{BLE::Instance()};
 Mytime::Controllers::DateTimeController date_time_controller;
 Mytime::Controllers::NotificationManager notification_manager;
 Mytime::Controllers::CurrentTimeService current_time_service(date_time_controller);
 Mytime::Controllers::AlertNotificationService alert_notification_service(notification_manager);
 Mytime::Controllers::BLEProcess ble_process(*queue, ble_interface);
+Mytime::Controllers::DisplayFlush display_flush(*queue);
+Mytime::Controllers::RenderScheduler render_scheduler(*queue);
+Mytime::Controllers::ScrollTransition scroll_transition(*queue, display_flush);
 mbed::Callback<void(BLE&, events::EventQueue&)> post_init_cb[] = {
     callback(&current_time_service, &Mytime::Controllers::CurrentTimeService::start),
     callback(&alert_notification_service, &Mytime::Controllers::AlertNotificationService::start),
     NULL
 };
 
+#if GC9A01_BUF_MODE == GC9A01_BUF_FULL
+#define DISP_BUF_LINES LV_VER_RES_MAX
+#else
+#define DISP_BUF_LINES GC9A01_BUF_LINES
+#endif
+// Set to 1 to print the time taken by each screen refresh
+#define DISP_MONITOR 0
+// Set to 1 to time the round text layout over RTT at start up
+#define TEXT_LAYOUT_BENCHMARK 0
+// Set to 1 to switch apps many times at start up and print any memory not given back
+#define APP_SWITCH_SOAK 0
+// Set to 1 to post UI commands from several threads and an interrupt at start up
+#define UI_QUEUE_STRESS 0
+
 lv_disp_buf_t disp_buf;
-lv_color_t buf[LV_HOR_RES_MAX * 10];
+lv_color_t buf[LV_HOR_RES_MAX * DISP_BUF_LINES];
+#if GC9A01_BUF_MODE == GC9A01_BUF_DOUBLE
+// Only pays off with GC9A01_FLUSH_ASYNC, otherwise the flush still blocks rendering
+lv_color_t buf2[LV_HOR_RES_MAX * DISP_BUF_LINES];
+#define DISP_BUF_COUNT 2
+#else
+lv_color_t *buf2 = NULL;
+#define DISP_BUF_COUNT 1
+#endif
 lv_disp_drv_t disp_drv;
 
 PwmOut VibMotor(P0_12);
@@ -78,7 +127,11 @@ DigitalOut light_level1(P0_30, 0);
 DigitalOut light_level2(P0_28, 0);
 DigitalOut light_level3(P0_31, 0);
 
+Mytime::Controllers::DisplayPowerManager display_power(*queue, display_flush, light_level1, light_level2, light_level3);
+
+#if !LV_TICK_CUSTOM
 Ticker ticker;
+#endif
 static lv_obj_t *s_background_obj;
 
 /**********************
@@ -87,6 +140,7 @@ static lv_obj_t *s_background_obj;
 /*Declare the "source code image" which is stored in the flash*/
 LV_IMG_DECLARE(warning)
 
+#if !LV_TICK_CUSTOM
 void lvl_ticker_func()
 {
   // printf("lvl_ticker_func: ENTER \r\n");
@@ -98,25 +152,50 @@ void lvl_ticker_func()
   //It will redraw the screen if required, handle input devices etc.  
   // lv_task_handler();
 }
+#endif
+
+#if DISP_MONITOR
+// Called by LVGL after each refresh with the time it took and pixels drawn
+void disp_monitor(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+  SEGGER_RTT_printf(0, "refr: %u ms, %u px, %u merged, %u wakeups/min\r\n", time, px,
+    Mytime::Controllers::AreaCoalescer::merged_last(), render_scheduler.wakeups_per_minute());
+  display_power.report();
+  Mytime::Windows::StyleRegistry::report();
+  Mytime::Windows::TickTimerService::report();
+#if GC9A01_BUS_MONITOR
+  Mytime::Controllers::PanelMonitor::report(GC9A01_SPI_BAUD, GC9A01_SPI_BITS);
+  Mytime::Controllers::PanelMonitor::reset();
+#endif
+}
+#endif
 
 void button_RTop()
 {
   SEGGER_RTT_printf(0, "button_RTop:!\n");
+  display_power.user_activity();
+  Mytime::Controllers::UiCommandQueue::post(callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::scroll_up));
 }
 
 void button_RMiddle()
 {
   SEGGER_RTT_printf(0, "button_RMiddle:!\n");
+  display_power.user_activity();
+  Mytime::Controllers::UiCommandQueue::post(callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::show_next));
 }
 
 void button_RBottom()
 {
   SEGGER_RTT_printf(0, "button_RBottom:!\n");
+  display_power.user_activity();
+  Mytime::Controllers::UiCommandQueue::post(callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::scroll_down));
 }
 
 void button_LBottom()
 {
   SEGGER_RTT_printf(0, "button_LBottom:!\n");
+  display_power.user_activity();
+  Mytime::Controllers::UiCommandQueue::post(callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::show_previous));
 }
 
 void button_init()
@@ -137,59 +216,22 @@ lv_area_t get_bounds(const lv_obj_t *obj) {
   return cords_p;
 }
 
-void eventcb()
-{
-  // printf("eventcb()\r\n");
-  //Call lv_task_handler() periodically every few milliseconds. 
-  //It will redraw the screen if required, handle input devices etc.  
-  lv_task_handler();
-}
-
 void show_notification()
 {
-  // t->join(); // Make sure thread has terminated
-  if (t != nullptr)
-  {
-    delete t;
-  }
-
-  t = new Thread();
-  t->start(mbed::callback(&notificationDisplay, &Mytime::Controllers::NotificationDisplay::main));
+  app_executor.show(notification_app);
 }
 
 void show_watchface()
 {
   SEGGER_RTT_printf(0, "sw: E\r\n");
-  // t->join(); // Make sure thread has terminated
-  if (t != nullptr)
-  {
-    delete t;
-  }
-
-  t = new Thread();
-  t->start(mbed::callback(&watchFace, &Mytime::Controllers::WatchAPI::main));
+  app_executor.show(watch_app);
   SEGGER_RTT_printf(0, "sw: X\r\n");
 }
 
-void break_app_dispatch()
-{
-  SEGGER_RTT_printf(0, "break: E\r\n");
-  app_queue.break_dispatch();
-  SEGGER_RTT_printf(0, "break: bef\r\n");
-  t->join(); // wait for thread to terminate
-  SEGGER_RTT_printf(0, "break: af\r\n");
-
-  // Display notification
-  // queue->call(mbed::callback(&show_notification));
-
-  SEGGER_RTT_printf(0, "break: X\r\n");
-}
-
 void watchHandler()
 {
   SEGGER_RTT_printf(0, "\twatchHandler E\r\n");
-  app_queue.break_dispatch();
-  queue->call_in(1, mbed::callback(&show_watchface));
+  show_watchface();
 
   SEGGER_RTT_printf(0, "\twatchHandler X\r\n");
 }
@@ -207,8 +249,8 @@ void notificationHandler()
   // }
   // SEGGER_RTT_printf(0, "\r\n");
 
-  // app_queue.break_dispatch();
-  queue->call_in(1, mbed::callback(&show_notification));
+  display_power.user_activity();
+  show_notification();
 
   SEGGER_RTT_printf(0, "notificationHandler: X\r\n");
 }
@@ -272,6 +314,112 @@ void window_load() {
   lv_label_set_text(label, "Battery is low!\nConnect the charger.");
 }
 
+#if APP_SWITCH_SOAK
+// Open and close the watch face and notification windows, LVGL and heap use
+// must come back to where they started
+void app_switch_soak(uint32_t cycles)
+{
+  lv_mem_monitor_t mem_before;
+  lv_mem_monitor(&mem_before);
+#if MBED_HEAP_STATS_ENABLED
+  mbed_stats_heap_t heap_before;
+  mbed_stats_heap_get(&heap_before);
+#endif
+
+  for (uint32_t i = 0; i < cycles; i++)
+  {
+    watchFace.init();
+    watchFace.deinit();
+    notificationDisplay.init();
+    notificationDisplay.deinit();
+  }
+
+  lv_mem_monitor_t mem_after;
+  lv_mem_monitor(&mem_after);
+  SEGGER_RTT_printf(0, "soak: %u switches, LVGL %d bytes, windows in use %d\r\n", cycles * 2,
+    (int)(mem_after.total_size - mem_after.free_size) - (int)(mem_before.total_size - mem_before.free_size),
+    Mytime::Windows::WindowPool::in_use());
+#if MBED_HEAP_STATS_ENABLED
+  mbed_stats_heap_t heap_after;
+  mbed_stats_heap_get(&heap_after);
+  SEGGER_RTT_printf(0, "soak: heap %d bytes\r\n", (int)heap_after.current_size - (int)heap_before.current_size);
+#endif
+}
+#endif
+
+#if UI_QUEUE_STRESS
+#define UI_QUEUE_STRESS_THREADS 3
+#define UI_QUEUE_STRESS_POSTS 2000
+
+// Every command posted must run exactly once, in the render context
+uint32_t stress_runs = 0;
+volatile uint32_t stress_isr_posts = 0;
+volatile uint32_t stress_retries = 0;
+Thread *stress_threads[UI_QUEUE_STRESS_THREADS];
+Ticker stress_ticker;
+
+void stress_command()
+{
+  stress_runs++;
+}
+
+void stress_producer()
+{
+  for (uint32_t i = 0; i < UI_QUEUE_STRESS_POSTS; i++)
+  {
+    while (!Mytime::Controllers::UiCommandQueue::post(callback(&stress_command)))
+    {
+      core_util_atomic_incr_u32(&stress_retries, 1);
+      ThisThread::yield();
+    }
+  }
+}
+
+void stress_isr()
+{
+  if (Mytime::Controllers::UiCommandQueue::post(callback(&stress_command)))
+  {
+    stress_isr_posts++;
+  }
+}
+
+void ui_queue_stress_report()
+{
+  stress_ticker.detach();
+  for (Thread *thread : stress_threads)
+  {
+    // Joining here would stop the drain the producers wait for, check back later
+    if (thread->get_state() != Thread::Deleted)
+    {
+      queue->call_in(100, callback(&ui_queue_stress_report));
+      return;
+    }
+  }
+  for (Thread *thread : stress_threads)
+  {
+    delete thread;
+  }
+  // Let the last commands run first
+  Mytime::Controllers::UiCommandQueue::drain();
+
+  uint32_t expected = UI_QUEUE_STRESS_THREADS * UI_QUEUE_STRESS_POSTS + stress_isr_posts;
+  SEGGER_RTT_printf(0, "ui queue stress: %s, %u of %u run, %u retries, %u dropped, high water %u\r\n",
+    stress_runs == expected ? "PASS" : "FAIL", stress_runs, expected, stress_retries,
+    Mytime::Controllers::UiCommandQueue::dropped(), Mytime::Controllers::UiCommandQueue::high_water());
+}
+
+void ui_queue_stress()
+{
+  for (Thread *&thread : stress_threads)
+  {
+    thread = new Thread(osPriorityNormal, 1024);
+    thread->start(callback(&stress_producer));
+  }
+  stress_ticker.attach_us(callback(&stress_isr), 500);
+  queue->call_in(5000, callback(&ui_queue_stress_report));
+}
+#endif
+
 void init_ble()
 {
     SEGGER_RTT_printf(0, "init_ble: ble_process.on_init()\r\n");
@@ -289,22 +437,49 @@ void lvgl_init()
     lv_init();
 
     printf("main: lv_init() done\r\n");
-    lv_disp_buf_init(&disp_buf, buf, NULL, LV_HOR_RES_MAX * 10);
-    printf("main: lv_disp_buf_init() done\r\n");
+    lv_disp_buf_init(&disp_buf, buf, buf2, LV_HOR_RES_MAX * DISP_BUF_LINES);
+    printf("main: lv_disp_buf_init() done, mode=%d, lines=%d, bytes=%u\r\n", GC9A01_BUF_MODE, DISP_BUF_LINES,
+      (unsigned)(sizeof(buf) * DISP_BUF_COUNT));
+
+    Mytime::Controllers::RoundPanel::init();
 
     lv_disp_drv_init(&disp_drv);
+#if GC9A01_FLUSH_ASYNC || GC9A01_FLUSH_ROUND
+    display_flush.start(disp_drv);
+#else
     disp_drv.flush_cb = GC9A01_flush;
+#endif
     disp_drv.buffer = &disp_buf;
-    lv_disp_drv_register(&disp_drv);
+#if GC9A01_RENDER_ROUND
+    disp_drv.rounder_cb = &Mytime::Controllers::RoundPanel::rounder_cb;
+#endif
+#if LV_USE_GPU && GC9A01_GPU_FILL
+    disp_drv.gpu_fill_cb = &Mytime::Controllers::FillAccelerator::gpu_fill_cb;
+#endif
+#if DISP_MONITOR
+    disp_drv.monitor_cb = disp_monitor;
+#endif
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+#if GC9A01_COALESCE
+    Mytime::Controllers::AreaCoalescer::start(disp);
+#endif
 
     printf("main: lv_disp_drv_register() done\r\n");
 
+#if !LV_TICK_CUSTOM
     ticker.attach_us(mbed::callback(&lvl_ticker_func), TICKER_TIME);
 
     printf("main: ticker.attach() done\r\n");
+#endif
+
+    // Run lv_task_handler only when an LVGL task is due or the UI changed
+    render_scheduler.start();
 
-    // Set callback for lv_task_handler to redraw the screen if necessary
-    queue->call_every(5, mbed::callback(&eventcb));
+    // Animated window pushes and pops slide with the panel's vertical scroll
+    scroll_transition.start();
+
+    // Dim and then switch the panel off when left alone
+    display_power.start();
 
     // window_load();
 }
@@ -361,6 +536,20 @@ int main()
     // Display graphics init
     lvgl_init();
 
+#if TEXT_LAYOUT_BENCHMARK
+    Mytime::Windows::TextLayoutBenchmark::run();
+#endif
+#if APP_SWITCH_SOAK
+    app_switch_soak(1000);
+#endif
+
+    // Apps are switched through the UiCommandQueue, app timers run from here on
+    app_executor.start();
+
+#if UI_QUEUE_STRESS
+    ui_queue_stress();
+#endif
+
     // Display watchface
     // queue->call(mbed::callback(&show_watchface));
     queue->call(mbed::callback(&notificationHandler));
@@ -0,0 +1,150 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "AppExecutor.h"
+#include "UiCommandQueue.h"
+#include "RenderScheduler.h"
+#include "HeapCounter.h"
+#include "TestCheck.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Mytime::Controllers;
+
+// Switches run when the test drains the queue, as the render context would
+void RenderScheduler::kick()
+{
+}
+
+static const uint32_t Switches = 1000;
+
+struct StubApp
+{
+    uint32_t inits;
+    uint32_t deinits;
+
+    void init() { inits++; };
+    void deinit() { deinits++; };
+    // What each app's thread ran before AppExecutor
+    void main() {};
+};
+
+static StubApp face, notification;
+static events::EventQueue app_queue;
+
+// Every switch prints a line, keep them out of the results
+static int quiet()
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+}
+
+static void loud(int saved)
+{
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+static void report(const char *path, uint32_t allocs)
+{
+    printf("%-12s %6u switches %6u allocs, %.2f per switch\n", path, Switches, allocs, (double)allocs / Switches);
+}
+
+/**
+ * Switching through the UiCommandQueue allocates nothing, the timer thread
+ * and its stack are allocated once at start().
+ */
+static uint32_t test_executor()
+{
+    AppExecutor executor(app_queue);
+    AppExecutor::App apps[] = {
+        {"face", mbed::callback(&face, &StubApp::init), mbed::callback(&face, &StubApp::deinit)},
+        {"notification", mbed::callback(&notification, &StubApp::init), mbed::callback(&notification, &StubApp::deinit)},
+    };
+
+    uint32_t before = heap_allocs();
+    executor.start();
+    CHECK_EQ(heap_allocs() - before, 1u);
+
+    before = heap_allocs();
+    int saved = quiet();
+    for (uint32_t i = 0; i < Switches; i++) {
+        executor.show(apps[i % 2]);
+        UiCommandQueue::drain();
+    }
+    loud(saved);
+    uint32_t allocs = heap_allocs() - before;
+
+    report("AppExecutor", allocs);
+    CHECK_EQ(allocs, 0u);
+    CHECK_EQ(face.inits, Switches / 2);
+    CHECK_EQ(notification.inits, Switches / 2);
+    CHECK_EQ(face.deinits + notification.deinits, Switches - 1);
+    CHECK(executor.current() == &apps[(Switches - 1) % 2]);
+
+    // Only the latest of several requests is shown
+    saved = quiet();
+    executor.show(apps[0]);
+    executor.show(apps[1]);
+    executor.show(apps[0]);
+    UiCommandQueue::drain();
+    loud(saved);
+    CHECK(executor.current() == &apps[0]);
+    CHECK_EQ(face.inits, Switches / 2 + 1);
+    CHECK_EQ(notification.inits, Switches / 2);
+
+    return allocs;
+}
+
+/**
+ * The path AppExecutor replaced: the previous Thread deleted and a new one
+ * started for every app shown.
+ */
+static uint32_t test_thread_per_switch()
+{
+    StubApp *apps[] = {&face, &notification};
+    Thread *t = nullptr;
+
+    uint32_t before = heap_allocs();
+    for (uint32_t i = 0; i < Switches; i++) {
+        delete t;
+        t = new Thread();
+        t->start(mbed::callback(apps[i % 2], &StubApp::main));
+    }
+    uint32_t allocs = heap_allocs() - before;
+    delete t;
+
+    report("Thread each", allocs);
+    // The Thread and its stack
+    CHECK_EQ(allocs, 2 * Switches);
+    return allocs;
+}
+
+int main()
+{
+    uint32_t executor = test_executor();
+    uint32_t threads = test_thread_per_switch();
+    CHECK(executor < threads);
+
+    return test_result("AppExecutorTest");
+}
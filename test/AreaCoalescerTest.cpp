@@ -0,0 +1,195 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "AreaCoalescer.h"
+#include "TestCheck.h"
+
+using namespace Mytime::Controllers;
+
+// Counted by the lvgl stub
+extern uint32_t host_refr_runs;
+
+static lv_disp_t disp;
+
+static void set_areas(const lv_area_t *areas, uint16_t count)
+{
+    memset(&disp, 0, sizeof(disp));
+    for (uint16_t i = 0; i < count; i++) {
+        disp.inv_areas[i] = areas[i];
+    }
+    disp.inv_p = count;
+}
+
+static uint32_t total_cost(const lv_area_t *areas, const uint8_t *joined, uint16_t count)
+{
+    uint32_t cost = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (!joined[i]) {
+            cost += 48 + lv_area_get_size(&areas[i]);
+        }
+    }
+    return cost;
+}
+
+static bool covered(int x, int y)
+{
+    for (uint16_t i = 0; i < disp.inv_p; i++) {
+        const lv_area_t &a = disp.inv_areas[i];
+        if (!disp.inv_area_joined[i] && x >= a.x1 && x <= a.x2 && y >= a.y1 && y <= a.y2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_neighbours_merge()
+{
+    const lv_area_t areas[] = {{0, 0, 9, 9}, {10, 0, 19, 9}};
+    set_areas(areas, 2);
+
+    CHECK_EQ(AreaCoalescer::coalesce(&disp), 1);
+    CHECK_EQ(disp.inv_p, 1);
+    CHECK_EQ(disp.inv_areas[0].x1, 0);
+    CHECK_EQ(disp.inv_areas[0].x2, 19);
+    CHECK_EQ(disp.inv_areas[0].y2, 9);
+}
+
+static void test_gap_against_overhead()
+{
+    // 2 px of gap costs less than a second area
+    const lv_area_t near[] = {{0, 0, 9, 0}, {12, 0, 21, 0}};
+    set_areas(near, 2);
+    CHECK_EQ(AreaCoalescer::coalesce(&disp), 1);
+    CHECK_EQ(disp.inv_p, 1);
+
+    // 99 px of gap does not
+    const lv_area_t far[] = {{0, 0, 0, 0}, {0, 100, 0, 100}};
+    set_areas(far, 2);
+    CHECK_EQ(AreaCoalescer::coalesce(&disp), 0);
+    CHECK_EQ(disp.inv_p, 2);
+
+    const lv_area_t apart[] = {{0, 0, 9, 9}, {200, 200, 209, 209}};
+    set_areas(apart, 2);
+    CHECK_EQ(AreaCoalescer::coalesce(&disp), 0);
+    CHECK_EQ(disp.inv_areas[1].x1, 200);
+}
+
+static void test_chain_packs_list()
+{
+    // The middle area bridges the outer two, the far one stays on its own
+    const lv_area_t areas[] = {{0, 0, 9, 9}, {200, 200, 219, 219}, {20, 0, 29, 9}, {10, 0, 19, 9}};
+    set_areas(areas, 4);
+
+    CHECK_EQ(AreaCoalescer::coalesce(&disp), 2);
+    CHECK_EQ(disp.inv_p, 2);
+
+    bool found_row = false;
+    bool found_far = false;
+    for (uint16_t i = 0; i < disp.inv_p; i++) {
+        const lv_area_t &a = disp.inv_areas[i];
+        found_row |= (a.x1 == 0 && a.x2 == 29 && a.y1 == 0 && a.y2 == 9);
+        found_far |= (a.x1 == 200 && a.x2 == 219);
+    }
+    CHECK(found_row);
+    CHECK(found_far);
+}
+
+static void test_joined_areas_left_alone()
+{
+    // Area 1 is already inside area 0 for lvgl, it must not be merged again
+    const lv_area_t areas[] = {{0, 0, 9, 9}, {2, 2, 5, 5}, {100, 100, 109, 109}, {100, 110, 109, 119}};
+    set_areas(areas, 4);
+    disp.inv_area_joined[1] = 1;
+
+    CHECK_EQ(AreaCoalescer::coalesce(&disp), 1);
+    CHECK_EQ(disp.inv_p, 3);
+
+    uint8_t joined = 0;
+    for (uint16_t i = 0; i < disp.inv_p; i++) {
+        if (disp.inv_area_joined[i]) {
+            joined++;
+            CHECK_EQ(disp.inv_areas[i].x1, 2);
+            CHECK_EQ(disp.inv_areas[i].y2, 5);
+        }
+    }
+    CHECK_EQ(joined, 1);
+}
+
+static void test_random_never_loses_pixels()
+{
+    srand(5);
+    for (int n = 0; n < 500; n++) {
+        lv_area_t areas[LV_INV_BUF_SIZE];
+        uint16_t count = 2 + rand() % 12;
+        for (uint16_t i = 0; i < count; i++) {
+            lv_coord_t x = rand() % 230;
+            lv_coord_t y = rand() % 230;
+            lv_area_set(&areas[i], x, y, x + rand() % 10, y + rand() % 10);
+        }
+        set_areas(areas, count);
+
+        uint8_t none[LV_INV_BUF_SIZE] = {0};
+        uint32_t before = total_cost(areas, none, count);
+        uint8_t merged = AreaCoalescer::coalesce(&disp);
+
+        CHECK_EQ(disp.inv_p, count - merged);
+        CHECK(total_cost(disp.inv_areas, disp.inv_area_joined, disp.inv_p) <= before);
+        for (uint16_t i = 0; i < count; i++) {
+            CHECK(covered(areas[i].x1, areas[i].y1));
+            CHECK(covered(areas[i].x2, areas[i].y2));
+        }
+    }
+}
+
+static void test_refresh_task()
+{
+    lv_task_t task;
+    memset(&task, 0, sizeof(task));
+
+    const lv_area_t areas[] = {{0, 0, 9, 9}, {10, 0, 19, 9}, {20, 0, 29, 9}};
+    set_areas(areas, 3);
+    disp.refr_task = &task;
+    task.user_data = &disp;
+
+    AreaCoalescer::start(&disp);
+    CHECK(task.task_cb != nullptr);
+
+    uint32_t runs = host_refr_runs;
+    task.task_cb(&task);
+    CHECK_EQ(host_refr_runs, runs + 1);
+    CHECK_EQ(AreaCoalescer::merged_last(), 2);
+    CHECK_EQ(AreaCoalescer::merged_total(), 2);
+    CHECK_EQ(disp.inv_p, 1);
+
+    // A single area is passed straight on
+    task.task_cb(&task);
+    CHECK_EQ(host_refr_runs, runs + 2);
+    CHECK_EQ(AreaCoalescer::merged_last(), 0);
+    CHECK_EQ(AreaCoalescer::merged_total(), 2);
+}
+
+int main()
+{
+    test_neighbours_merge();
+    test_gap_against_overhead();
+    test_chain_packs_list();
+    test_joined_areas_left_alone();
+    test_random_never_loses_pixels();
+    test_refresh_task();
+
+    return test_result("AreaCoalescerTest");
+}
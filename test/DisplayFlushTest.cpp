@@ -0,0 +1,276 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "lv_drv_conf.h"
+#include "DisplayFlush.h"
+#include "RoundPanel.h"
+#include "FillAccelerator.h"
+#include "HostHal.h"
+#include "PanelMonitor.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+static const uint32_t FrameBytes = LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(lv_color_t);
+
+static events::EventQueue queue;
+static DisplayFlush *flush = nullptr;
+static lv_disp_buf_t disp_buf;
+static lv_disp_drv_t drv;
+
+static uint16_t pattern(lv_coord_t x, lv_coord_t y)
+{
+    return (uint16_t)((x * 31 / 239) << 11 | (y * 63 / 239) << 5 | ((x ^ y) & 0x1F));
+}
+
+// LV_COLOR_16_SWAP keeps pixels in bus byte order
+static lv_color_t swapped(uint16_t c)
+{
+    lv_color_t color;
+    color.full = (uint16_t)((c >> 8) | (c << 8));
+    return color;
+}
+
+static void setup()
+{
+    host_hal_reset();
+    memset(&drv, 0, sizeof(drv));
+    memset(&disp_buf, 0, sizeof(disp_buf));
+    drv.buffer = &disp_buf;
+
+    // A new one for each test, its byte counts start at zero
+    delete flush;
+    flush = new DisplayFlush(queue);
+    flush->start(drv);
+
+    const uint8_t colmod = 0x55;
+    flush->write_command(0x11, nullptr, 0);
+    flush->write_command(0x3A, &colmod, 1);
+    flush->write_command(0x29, nullptr, 0);
+}
+
+/**
+ * Hand an area to the flush the way LVGL does and wait until the buffer is
+ * released, moving the bus along from wait_cb like LVGL's wait loop.
+ */
+static void flush_area(const lv_area_t &area, lv_color_t *pixels)
+{
+    lv_area_copy(&disp_buf.area, &area);
+    disp_buf.flushing = 1;
+    drv.flush_cb(&drv, &area, pixels);
+
+    for (int spins = 0; disp_buf.flushing && spins < 100000; spins++) {
+        host_hal_complete();
+        drv.wait_cb(&drv);
+    }
+    CHECK(!disp_buf.flushing);
+}
+
+static void flush_pattern(const lv_area_t &area)
+{
+    std::vector<lv_color_t> pixels;
+    for (lv_coord_t y = area.y1; y <= area.y2; y++) {
+        for (lv_coord_t x = area.x1; x <= area.x2; x++) {
+            pixels.push_back(swapped(pattern(x, y)));
+        }
+    }
+    flush_area(area, pixels.data());
+}
+
+// Strips like the 10 line draw buffers
+static void flush_frame(lv_coord_t lines)
+{
+    for (lv_coord_t y = 0; y < LV_VER_RES_MAX; y += lines) {
+        lv_area_t area;
+        lv_area_set(&area, 0, y, LV_HOR_RES_MAX - 1, LV_MATH_MIN(y + lines, LV_VER_RES_MAX) - 1);
+        flush_pattern(area);
+    }
+}
+
+/**
+ * Every pixel of the area the glass shows holds the pattern.
+ */
+static bool shows_pattern(const lv_area_t &area)
+{
+    const PanelEmulator &panel = host_panel();
+    for (lv_coord_t y = area.y1; y <= area.y2; y++) {
+        for (lv_coord_t x = area.x1; x <= area.x2; x++) {
+            if (PanelEmulator::visible(x, y) && panel.memory(x, y) != pattern(x, y)) {
+                printf("pixel %d,%d is %04x, not %04x\n", x, y, panel.memory(x, y), pattern(x, y));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_full_and_round_frames()
+{
+    lv_area_t screen;
+    lv_area_set(&screen, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+
+    setup();
+    flush->set_round(false);
+    PanelMonitor::reset();
+    flush_frame(10);
+    const PanelMonitor::Stats full = PanelMonitor::stats();
+    uint32_t full_us = PanelMonitor::bus_time_us(GC9A01_SPI_BAUD, 8);
+    CHECK(shows_pattern(screen));
+    CHECK_EQ(full.pixel_bytes, FrameBytes);
+    CHECK_EQ(flush->bytes_sent(), FrameBytes);
+    CHECK_EQ(full.overruns, 0);
+
+    setup();
+    flush->set_round(true);
+    PanelMonitor::reset();
+    flush_frame(10);
+    const PanelMonitor::Stats round = PanelMonitor::stats();
+    uint32_t round_us = PanelMonitor::bus_time_us(GC9A01_SPI_BAUD, 8);
+    CHECK(shows_pattern(screen));
+    CHECK_EQ(round.overruns, 0);
+    CHECK_EQ(round.pixel_bytes, flush->bytes_sent());
+
+    // Every byte is either sent or skipped, and most corner bytes are skipped
+    CHECK_EQ(flush->bytes_sent() + flush->bytes_skipped(), FrameBytes);
+    CHECK(round.pixel_bytes < FrameBytes * 85 / 100);
+    CHECK(round_us < full_us);
+    CHECK(host_panel().stats().hidden_pixels < host_panel().stats().pixels / 20);
+
+    printf("full frame in 10 line strips at %d Hz:\n", GC9A01_SPI_BAUD);
+    printf("  rectangles: %u pixel bytes, %u commands, %u us\n", full.pixel_bytes, full.commands, full_us);
+    printf("  round spans: %u pixel bytes, %u commands, %u us\n", round.pixel_bytes, round.commands, round_us);
+
+    CHECK(host_panel().write_ppm("DisplayFlushTest.ppm"));
+}
+
+static void test_random_areas()
+{
+    srand(3);
+    for (int round = 0; round <= 1; round++) {
+        setup();
+        flush->set_round(round);
+        for (int n = 0; n < 300; n++) {
+            lv_area_t area;
+            lv_coord_t x1 = rand() % LV_HOR_RES_MAX;
+            lv_coord_t y1 = rand() % LV_VER_RES_MAX;
+            lv_area_set(&area, x1, y1, x1 + rand() % (LV_HOR_RES_MAX - x1), y1 + rand() % (LV_VER_RES_MAX - y1));
+
+            uint32_t sent = flush->bytes_sent();
+            uint32_t skipped = flush->bytes_skipped();
+            flush_pattern(area);
+            CHECK(shows_pattern(area));
+            CHECK_EQ(flush->bytes_sent() - sent + flush->bytes_skipped() - skipped, lv_area_get_size(&area) * 2);
+        }
+        CHECK_EQ(PanelMonitor::stats().overruns, 0);
+    }
+}
+
+static void test_corner_area()
+{
+    setup();
+    flush->set_round(true);
+
+    // Nothing of it is on the glass, released without a byte sent
+    lv_area_t area;
+    lv_area_set(&area, 0, 0, 15, 15);
+    flush_pattern(area);
+    CHECK_EQ(flush->bytes_sent(), 0);
+    CHECK_EQ(PanelMonitor::stats().pixel_bytes, 0);
+}
+
+static void test_full_frame_buffer()
+{
+    // One area larger than a DMA transfer goes out in RAMWRC chunks
+    setup();
+    flush->set_round(false);
+    lv_area_t screen;
+    lv_area_set(&screen, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    flush_pattern(screen);
+    CHECK(shows_pattern(screen));
+    CHECK(PanelMonitor::stats().memory_writes > 1);
+    CHECK_EQ(PanelMonitor::stats().overruns, 0);
+}
+
+static void test_held_transfers()
+{
+    // Transfers finish one at a time while LVGL waits, as with DMA
+    setup();
+    host_hal_hold_transfers(true);
+    flush->set_round(true);
+    flush_frame(24);
+
+    lv_area_t screen;
+    lv_area_set(&screen, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    CHECK(shows_pattern(screen));
+    CHECK(!host_hal_complete());
+    host_hal_hold_transfers(false);
+}
+
+static void test_solid_flush()
+{
+    setup();
+    host_hal_hold_transfers(true);
+    flush->set_round(true);
+
+    const lv_coord_t w = LV_HOR_RES_MAX;
+    const lv_coord_t h = 20;
+    std::vector<lv_color_t> pixels(w * h);
+    lv_area_t area;
+    lv_area_set(&area, 0, 110, w - 1, 110 + h - 1);
+    lv_area_copy(&disp_buf.area, &area);
+
+    lv_area_t fill;
+    lv_area_set(&fill, 0, 0, w - 1, h - 1);
+    FillAccelerator::gpu_fill_cb(&drv, pixels.data(), w, &fill, swapped(0x07E0));
+
+    // Released straight away, the pixels come from the pattern buffer
+    uint32_t solid = FillAccelerator::solid_flushes();
+    disp_buf.flushing = 1;
+    drv.flush_cb(&drv, &area, pixels.data());
+    CHECK(!disp_buf.flushing);
+    CHECK_EQ(FillAccelerator::solid_flushes(), solid + 1);
+    memset(pixels.data(), 0, pixels.size() * sizeof(lv_color_t));
+
+    while (host_hal_complete()) {
+        drv.wait_cb(&drv);
+    }
+    host_hal_hold_transfers(false);
+
+    for (lv_coord_t y = area.y1; y <= area.y2; y++) {
+        for (lv_coord_t x = 0; x < w; x++) {
+            if (PanelEmulator::visible(x, y)) {
+                CHECK_EQ(host_panel().memory(x, y), 0x07E0);
+            }
+        }
+    }
+}
+
+int main()
+{
+    RoundPanel::init();
+
+    test_full_and_round_frames();
+    test_random_areas();
+    test_corner_area();
+    test_full_frame_buffer();
+    test_held_transfers();
+    test_solid_flush();
+
+    return test_result("DisplayFlushTest");
+}
@@ -0,0 +1,204 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "lv_drv_conf.h"
+#include "DisplayFlush.h"
+#include "HostHal.h"
+#include "PanelMonitor.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+/**
+ * Frame time and RAM of the GC9A01_BUF_MODE draw buffer choices.
+ *
+ * LVGL cannot render on the host, so each screen's invalidated area is cut
+ * into strips the way LVGL fills its buffers and every strip goes through
+ * the real DisplayFlush onto the emulator. Bus time comes from PanelMonitor
+ * at GC9A01_SPI_BAUD. Rendering is modelled at RenderNsPerPx, or the ns per
+ * pixel given as the first argument, e.g. worked out from DISP_MONITOR in
+ * main.cpp.
+ *
+ * One buffer renders and flushes in turn. With two, a strip renders while
+ * the previous one is on the bus, and waits for its own buffer to be sent.
+ *
+ * Fails when two buffers are slower than one of the same height, or the
+ * GC9A01_BUF_MODE set in lv_drv_conf.h is slower than a single strip.
+ */
+
+static constexpr uint32_t RenderNsPerPx = 250;
+
+struct Mode
+{
+    const char *name;
+    int mode;
+    lv_coord_t lines;
+};
+
+struct Screen
+{
+    const char *name;
+    lv_area_t area;
+};
+
+static events::EventQueue queue;
+static DisplayFlush *flush = nullptr;
+static lv_disp_buf_t disp_buf;
+static lv_disp_drv_t drv;
+
+static void setup()
+{
+    host_hal_reset();
+    memset(&drv, 0, sizeof(drv));
+    memset(&disp_buf, 0, sizeof(disp_buf));
+    drv.buffer = &disp_buf;
+
+    delete flush;
+    flush = new DisplayFlush(queue);
+    flush->start(drv);
+
+    const uint8_t colmod = 0x55;
+    flush->write_command(0x11, nullptr, 0);
+    flush->write_command(0x3A, &colmod, 1);
+    flush->write_command(0x29, nullptr, 0);
+}
+
+// Bus time of one strip
+static uint32_t flush_strip(const lv_area_t &area, lv_color_t *pixels)
+{
+    PanelMonitor::reset();
+    lv_area_copy(&disp_buf.area, &area);
+    disp_buf.flushing = 1;
+    drv.flush_cb(&drv, &area, pixels);
+
+    for (int spins = 0; disp_buf.flushing && spins < 100000; spins++) {
+        host_hal_complete();
+        drv.wait_cb(&drv);
+    }
+    CHECK(!disp_buf.flushing);
+    return PanelMonitor::bus_time_us(GC9A01_SPI_BAUD, 8);
+}
+
+/**
+ * Time to draw the area in strips, from the first render to the last byte.
+ */
+static uint32_t frame_us(const Mode &mode, const lv_area_t &area, uint32_t ns_per_px)
+{
+    lv_coord_t width = lv_area_get_width(&area);
+    lv_coord_t rows = (mode.mode == GC9A01_BUF_FULL) ? LV_VER_RES_MAX : mode.lines;
+    std::vector<lv_color_t> pixels((size_t)width * rows);
+
+    setup();
+
+    uint32_t render_start = 0;
+    uint32_t flush_end[2] = {0, 0};
+    uint8_t buf = 0;
+    uint32_t end = 0;
+
+    for (lv_coord_t y = area.y1; y <= area.y2; y += rows) {
+        lv_area_t strip;
+        lv_area_set(&strip, area.x1, y, area.x2, LV_MATH_MIN(y + rows - 1, area.y2));
+        for (lv_color_t &px : pixels) {
+            px.full = (uint16_t)(y * 0x0841);
+        }
+
+        // A buffer is only rendered into again once it has been sent
+        render_start = LV_MATH_MAX(render_start, flush_end[buf]);
+        uint32_t render_end = render_start + lv_area_get_size(&strip) * ns_per_px / 1000;
+        // LVGL waits for the previous flush before starting the next
+        uint32_t flush_start = LV_MATH_MAX(render_end, end);
+        end = flush_start + flush_strip(strip, pixels.data());
+        flush_end[buf] = end;
+
+        if (mode.mode == GC9A01_BUF_DOUBLE) {
+            buf ^= 1;
+            render_start = flush_start;
+        } else {
+            render_start = end;
+        }
+    }
+    return end;
+}
+
+static uint32_t ram_bytes(const Mode &mode)
+{
+    uint32_t lines = (mode.mode == GC9A01_BUF_FULL) ? LV_VER_RES_MAX : mode.lines;
+    uint32_t count = (mode.mode == GC9A01_BUF_DOUBLE) ? 2 : 1;
+    return LV_HOR_RES_MAX * lines * sizeof(lv_color_t) * count;
+}
+
+int main(int argc, char **argv)
+{
+    static const Mode modes[] = {
+        {"single", GC9A01_BUF_SINGLE, 10},
+        {"double", GC9A01_BUF_DOUBLE, 10},
+        {"single", GC9A01_BUF_SINGLE, 20},
+        {"double", GC9A01_BUF_DOUBLE, 20},
+        {"single", GC9A01_BUF_SINGLE, 40},
+        {"double", GC9A01_BUF_DOUBLE, 40},
+        {"full", GC9A01_BUF_FULL, LV_VER_RES_MAX},
+    };
+    static const Mode configured = {"config", GC9A01_BUF_MODE, GC9A01_BUF_LINES};
+    // A watch face drawn from scratch, a notification card, the time changing
+    static const Screen screens[] = {
+        {"watch face", {0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}},
+        {"notification", {20, 40, 219, 199}},
+        {"time", {60, 96, 179, 143}},
+    };
+    static const uint8_t ModeCount = sizeof(modes) / sizeof(modes[0]);
+    static const uint8_t ScreenCount = sizeof(screens) / sizeof(screens[0]);
+
+    uint32_t ns_per_px = (argc > 1) ? (uint32_t)atoi(argv[1]) : RenderNsPerPx;
+    printf("render %u ns/px, SPI %u Hz\n", ns_per_px, (unsigned)GC9A01_SPI_BAUD);
+    printf("%-6s %5s %7s", "mode", "lines", "RAM");
+    for (const Screen &screen : screens) {
+        printf(" %12s", screen.name);
+    }
+    printf("\n");
+
+    uint32_t times[ModeCount][ScreenCount];
+    for (uint8_t m = 0; m < ModeCount; m++) {
+        printf("%-6s %5d %7u", modes[m].name, modes[m].lines, ram_bytes(modes[m]));
+        for (uint8_t s = 0; s < ScreenCount; s++) {
+            times[m][s] = frame_us(modes[m], screens[s].area, ns_per_px);
+            printf(" %9u us", times[m][s]);
+        }
+        printf("\n");
+    }
+
+    for (uint8_t m = 0; m + 1 < ModeCount; m++) {
+        if (modes[m].mode == GC9A01_BUF_SINGLE && modes[m + 1].mode == GC9A01_BUF_DOUBLE) {
+            for (uint8_t s = 0; s < ScreenCount; s++) {
+                CHECK(times[m + 1][s] <= times[m][s]);
+            }
+        }
+    }
+
+    Mode single = {"single", GC9A01_BUF_SINGLE, GC9A01_BUF_LINES};
+    printf("%-6s %5d %7u", configured.name, configured.lines, ram_bytes(configured));
+    for (uint8_t s = 0; s < ScreenCount; s++) {
+        uint32_t us = frame_us(configured, screens[s].area, ns_per_px);
+        printf(" %9u us", us);
+        CHECK(us <= frame_us(single, screens[s].area, ns_per_px));
+    }
+    printf("\n");
+
+    delete flush;
+    return test_result("DrawBufferBenchmark");
+}
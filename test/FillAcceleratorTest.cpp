@@ -0,0 +1,138 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "FillAccelerator.h"
+#include "TestCheck.h"
+
+using namespace Mytime::Controllers;
+
+static const uint16_t Canary = 0xA5A5;
+
+static lv_color_t color(uint16_t full)
+{
+    lv_color_t c;
+    c.full = full;
+    return c;
+}
+
+static void test_fill_runs()
+{
+    // Word aligned and half word aligned starts, every length up to a few
+    // unrolled loops, with the pixels either side left alone
+    alignas(4) lv_color_t buf[64];
+
+    for (uint32_t start = 0; start < 4; start++) {
+        for (uint32_t px = 0; px < 40; px++) {
+            for (uint32_t i = 0; i < 64; i++) {
+                buf[i].full = Canary;
+            }
+
+            FillAccelerator::fill(&buf[start + 8], px, color(0x1234));
+
+            for (uint32_t i = 0; i < 64; i++) {
+                bool inside = i >= start + 8 && i < start + 8 + px;
+                CHECK_EQ(buf[i].full, inside ? 0x1234 : Canary);
+            }
+        }
+    }
+}
+
+static void test_gpu_fill_area()
+{
+    const lv_coord_t w = 20;
+    const lv_coord_t h = 10;
+    lv_color_t buf[w * h];
+    lv_disp_buf_t disp_buf;
+    lv_disp_drv_t drv;
+    lv_area_t area;
+
+    memset(&drv, 0, sizeof(drv));
+    memset(&disp_buf, 0, sizeof(disp_buf));
+    lv_area_set(&disp_buf.area, 40, 100, 40 + w - 1, 100 + h - 1);
+    drv.buffer = &disp_buf;
+
+    for (auto &px : buf) {
+        px.full = Canary;
+    }
+
+    // Part of some rows, relative to the buffer
+    uint32_t fills = FillAccelerator::fills();
+    lv_area_set(&area, 3, 2, 8, 6);
+    FillAccelerator::gpu_fill_cb(&drv, buf, w, &area, color(0xF800));
+    CHECK_EQ(FillAccelerator::fills(), fills + 1);
+
+    for (lv_coord_t y = 0; y < h; y++) {
+        for (lv_coord_t x = 0; x < w; x++) {
+            bool inside = x >= 3 && x <= 8 && y >= 2 && y <= 6;
+            CHECK_EQ(buf[y * w + x].full, inside ? 0xF800 : Canary);
+        }
+    }
+
+    lv_color_t solid;
+    CHECK(!FillAccelerator::take_solid(buf, w * h, solid));
+
+    // Whole rows run as one
+    lv_area_set(&area, 0, 4, w - 1, 5);
+    FillAccelerator::gpu_fill_cb(&drv, buf, w, &area, color(0x07E0));
+    for (lv_coord_t x = 0; x < w; x++) {
+        CHECK_EQ(buf[3 * w + x].full, (x >= 3 && x <= 8) ? 0xF800 : Canary);
+        CHECK_EQ(buf[4 * w + x].full, 0x07E0);
+        CHECK_EQ(buf[5 * w + x].full, 0x07E0);
+        CHECK_EQ(buf[6 * w + x].full, (x >= 3 && x <= 8) ? 0xF800 : Canary);
+    }
+}
+
+static void test_solid_buffer()
+{
+    const lv_coord_t w = 21;
+    const lv_coord_t h = 7;
+    lv_color_t buf[w * h];
+    lv_disp_buf_t disp_buf;
+    lv_disp_drv_t drv;
+    lv_area_t area;
+    lv_color_t solid;
+
+    memset(&drv, 0, sizeof(drv));
+    memset(&disp_buf, 0, sizeof(disp_buf));
+    lv_area_set(&disp_buf.area, 0, 0, w - 1, h - 1);
+    drv.buffer = &disp_buf;
+    lv_area_set(&area, 0, 0, w - 1, h - 1);
+
+    uint32_t solid_flushes = FillAccelerator::solid_flushes();
+    FillAccelerator::gpu_fill_cb(&drv, buf, w, &area, color(0x001F));
+    CHECK(FillAccelerator::take_solid(buf, w * h, solid));
+    CHECK_EQ(solid.full, 0x001F);
+    CHECK_EQ(FillAccelerator::solid_flushes(), solid_flushes + 1);
+
+    // Taken once only
+    CHECK(!FillAccelerator::take_solid(buf, w * h, solid));
+
+    // Something drawn over the fill
+    FillAccelerator::gpu_fill_cb(&drv, buf, w, &area, color(0x001F));
+    buf[w * h - 1].full = 0xFFFF;
+    CHECK(!FillAccelerator::take_solid(buf, w * h, solid));
+    CHECK_EQ(FillAccelerator::solid_flushes(), solid_flushes + 1);
+}
+
+int main()
+{
+    test_fill_runs();
+    test_gpu_fill_area();
+    test_solid_buffer();
+
+    return test_result("FillAcceleratorTest");
+}
@@ -0,0 +1,181 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "lv_drv_conf.h"
+#include "DisplayFlush.h"
+#include "FillAccelerator.h"
+#include "RoundPanel.h"
+#include "HostHal.h"
+#include "HostLvgl.h"
+#include "PanelMonitor.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+/**
+ * Fill heavy screens drawn with GC9A01_GPU_FILL on and off.
+ *
+ * With the mode on the driver's gpu_fill_cb is FillAccelerator, otherwise
+ * solid areas are filled by LVGL's pixel loop. Every screen is redrawn
+ * Frames times through the host refresh, DisplayFlush and the emulator
+ * with the draw buffers of lv_drv_conf.h. Reported are the fastest host
+ * time spent filling in a frame, the pixels filled each way, the flushes
+ * sent from a pattern instead of the draw buffer and the pixel bytes on
+ * the bus.
+ *
+ * Fails when the glass differs between the two, when a screen of solid
+ * strips is not flushed from a pattern with the mode on, or when filling
+ * takes longer with it.
+ */
+
+static constexpr int Frames = 20;
+
+struct Screen
+{
+    const char *name;
+    const HostLayer *layers;
+    uint8_t count;
+    bool solid;     // every strip is one colour
+};
+
+struct Result
+{
+    uint64_t fill_ns;
+    uint32_t gpu_px;
+    uint32_t software_px;
+    uint32_t solid_flushes;
+    uint32_t bytes;
+    std::vector<uint16_t> glass;
+};
+
+static uint16_t text(lv_coord_t x, lv_coord_t y)
+{
+    return ((x / 3 + y / 5) & 3) ? 0xFFFF : 0x0000;
+}
+
+// window_create(): a white 249 x 249 object centred on the screen
+#define WINDOW {{-4, -4, 244, 244}, 0xFFFF, NULL}
+#define SCREEN {{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0x0000, NULL}
+
+static const HostLayer window[] = {SCREEN, WINDOW};
+static const HostLayer alert[] = {SCREEN, WINDOW, {{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0xF800, NULL}};
+static const HostLayer card[] = {
+    SCREEN, WINDOW,
+    {{20, 80, 219, 159}, 0x001F, NULL},
+    {{40, 100, 199, 139}, 0, text},
+};
+
+static events::EventQueue queue;
+
+static Result draw(const Screen &screen, bool gpu)
+{
+    std::vector<lv_color_t> buf1((size_t)LV_HOR_RES_MAX * GC9A01_BUF_LINES);
+    std::vector<lv_color_t> buf2(GC9A01_BUF_MODE == GC9A01_BUF_DOUBLE ? buf1.size() : 0);
+    lv_disp_buf_t disp_buf;
+    lv_disp_drv_t drv;
+    DisplayFlush flush(queue);
+
+    host_hal_reset();
+    host_lvgl_reset();
+    host_screen_set(screen.layers, screen.count);
+
+    lv_disp_drv_init(&drv);
+    lv_disp_buf_init(&disp_buf, buf1.data(), buf2.empty() ? NULL : buf2.data(), buf1.size());
+    drv.buffer = &disp_buf;
+    drv.rounder_cb = &RoundPanel::rounder_cb;
+    if (gpu) {
+        drv.gpu_fill_cb = &FillAccelerator::gpu_fill_cb;
+    }
+    flush.start(drv);
+    lv_disp_t *disp = lv_disp_drv_register(&drv);
+
+    const uint8_t colmod = 0x55;
+    flush.write_command(0x11, nullptr, 0);
+    flush.write_command(0x3A, &colmod, 1);
+    flush.write_command(0x29, nullptr, 0);
+
+    Result result;
+    result.fill_ns = UINT64_MAX;
+    lv_area_t all;
+    lv_area_set(&all, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+
+    for (int n = 0; n < Frames; n++) {
+        HostRefrStats before = host_refr_stats();
+        uint32_t solid_flushes = FillAccelerator::solid_flushes();
+        PanelMonitor::reset();
+
+        _lv_inv_area(disp, &all);
+        lv_refr_now(disp);
+        flush.write_command(0x00, nullptr, 0);
+
+        const HostRefrStats &after = host_refr_stats();
+        result.fill_ns = LV_MATH_MIN(result.fill_ns, after.fill_ns - before.fill_ns);
+        result.gpu_px = after.gpu_px - before.gpu_px;
+        result.software_px = after.software_px - before.software_px;
+        result.solid_flushes = FillAccelerator::solid_flushes() - solid_flushes;
+        result.bytes = PanelMonitor::stats().pixel_bytes;
+    }
+
+    const PanelEmulator &panel = host_panel();
+    for (uint16_t y = 0; y < PanelEmulator::Height; y++) {
+        for (uint16_t x = 0; x < PanelEmulator::Width; x++) {
+            result.glass.push_back(PanelEmulator::visible(x, y) ? panel.shown(x, y) : 0);
+        }
+    }
+    return result;
+}
+
+int main()
+{
+    static const Screen screens[] = {
+        {"window", window, sizeof(window) / sizeof(window[0]), true},
+        {"alert", alert, sizeof(alert) / sizeof(alert[0]), true},
+        {"card", card, sizeof(card) / sizeof(card[0]), false},
+    };
+
+    RoundPanel::init();
+
+    printf("%d frames, %u lines %s buffered\n", Frames, (unsigned)GC9A01_BUF_LINES,
+        GC9A01_BUF_MODE == GC9A01_BUF_DOUBLE ? "double" : "single");
+    printf("%-7s %-4s %8s %8s %8s %6s %7s\n", "screen", "gpu", "fill us", "gpu px", "sw px", "solid", "bytes");
+
+    uint64_t fill_ns[2] = {0, 0};
+    for (const Screen &s : screens) {
+        Result results[2];
+        for (int gpu = 0; gpu < 2; gpu++) {
+            Result &res = results[gpu];
+            res = draw(s, gpu);
+            fill_ns[gpu] += res.fill_ns;
+            printf("%-7s %-4s %8.1f %8u %8u %6u %7u\n", s.name, gpu ? "on" : "off", res.fill_ns / 1000.0,
+                res.gpu_px, res.software_px, res.solid_flushes, res.bytes);
+        }
+
+        CHECK(results[0].glass == results[1].glass);
+        CHECK_EQ(results[0].solid_flushes, 0u);
+        CHECK_EQ(results[1].bytes, results[0].bytes);
+        if (s.solid) {
+            CHECK_EQ(results[1].solid_flushes, (uint32_t)(LV_VER_RES_MAX + GC9A01_BUF_LINES - 1) / GC9A01_BUF_LINES);
+        }
+    }
+
+    printf("fill time %.1f us off, %.1f us on\n", fill_ns[0] / 1000.0, fill_ns[1] / 1000.0);
+    CHECK(fill_ns[1] < fill_ns[0]);
+
+    return test_result("GpuFillBenchmark");
+}
@@ -0,0 +1,333 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "common.h"
+#include "HostHal.h"
+#include "PanelMonitor.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+static void command(uint8_t cmd, std::vector<uint8_t> params = {})
+{
+    pin_cmd_set(0);
+    spi_wr(cmd);
+    pin_cmd_set(1);
+    for (uint8_t p : params) {
+        spi_wr(p);
+    }
+}
+
+static void window(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+    command(0x2A, {(uint8_t)(x1 >> 8), (uint8_t)x1, (uint8_t)(x2 >> 8), (uint8_t)x2});
+    command(0x2B, {(uint8_t)(y1 >> 8), (uint8_t)y1, (uint8_t)(y2 >> 8), (uint8_t)y2});
+}
+
+// RGB565 pixels, high byte first as LV_COLOR_16_SWAP leaves them
+static void pixels(const std::vector<uint16_t> &colors)
+{
+    std::vector<char> bytes;
+    for (uint16_t c : colors) {
+        bytes.push_back((char)(c >> 8));
+        bytes.push_back((char)c);
+    }
+    pin_cmd_set(1);
+    spi_wr_mem(bytes.data(), bytes.size());
+}
+
+static void init()
+{
+    host_hal_reset();
+    command(0x11);
+    command(0x3A, {0x55});
+    command(0x36, {0x00});
+    command(0x29);
+}
+
+static void test_power()
+{
+    host_hal_reset();
+    PanelEmulator &panel = host_panel();
+    CHECK(!panel.awake());
+    CHECK(!panel.display_on());
+
+    init();
+    CHECK(panel.awake());
+    CHECK(panel.display_on());
+
+    window(0, 0, 0, 0);
+    command(0x2C);
+    pixels({0xFFFF});
+    CHECK_EQ(panel.shown(0, 0), 0xFFFF);
+
+    command(0x28);
+    CHECK_EQ(panel.shown(0, 0), 0);
+    CHECK_EQ(panel.memory(0, 0), 0xFFFF);
+    command(0x29);
+    command(0x10);
+    CHECK_EQ(panel.shown(0, 0), 0);
+}
+
+static void test_window_write()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+
+    // 10 x 5 window, written in two parts
+    std::vector<uint16_t> colors;
+    for (uint16_t i = 0; i < 50; i++) {
+        colors.push_back(0x1000 + i);
+    }
+    window(100, 20, 109, 24);
+    command(0x2C);
+    pixels(std::vector<uint16_t>(colors.begin(), colors.begin() + 23));
+    command(0x3C);
+    pixels(std::vector<uint16_t>(colors.begin() + 23, colors.end()));
+
+    for (uint16_t i = 0; i < 50; i++) {
+        CHECK_EQ(panel.memory(100 + i % 10, 20 + i / 10), colors[i]);
+    }
+    CHECK_EQ(panel.memory(99, 20), 0);
+    CHECK_EQ(panel.memory(110, 20), 0);
+    CHECK_EQ(panel.memory(100, 25), 0);
+    CHECK_EQ(panel.stats().pixels, 50);
+    CHECK_EQ(panel.stats().overruns, 0);
+
+    // Past the end goes back to the top left of the window
+    command(0x3C);
+    pixels({0xABCD, 0x1234});
+    CHECK_EQ(panel.stats().overruns, 2);
+    CHECK_EQ(panel.memory(100, 20), 0xABCD);
+    CHECK_EQ(panel.memory(101, 20), 0x1234);
+
+    // RAMWR starts over
+    command(0x2C);
+    pixels({0x5555});
+    CHECK_EQ(panel.memory(100, 20), 0x5555);
+}
+
+static void test_madctl()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+
+    command(0x36, {0x40});
+    window(0, 3, 1, 3);
+    command(0x2C);
+    pixels({0x0001, 0x0002});
+    CHECK_EQ(panel.memory(239, 3), 0x0001);
+    CHECK_EQ(panel.memory(238, 3), 0x0002);
+
+    command(0x36, {0x80});
+    window(5, 0, 5, 0);
+    command(0x2C);
+    pixels({0x0003});
+    CHECK_EQ(panel.memory(5, 239), 0x0003);
+
+    command(0x36, {0x20});
+    window(5, 7, 5, 7);
+    command(0x2C);
+    pixels({0x0004});
+    CHECK_EQ(panel.memory(7, 5), 0x0004);
+
+    // BGR only changes how memory is shown
+    command(0x36, {0x08});
+    window(0, 120, 0, 120);
+    command(0x2C);
+    pixels({0xF800});
+    CHECK_EQ(panel.memory(0, 120), 0xF800);
+    CHECK_EQ(panel.shown(0, 120), 0x001F);
+}
+
+static void test_18_bit()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+
+    command(0x3A, {0x66});
+    window(120, 120, 121, 120);
+    command(0x2C);
+    const char bytes[] = {(char)0xF8, (char)0xFC, (char)0xF8, (char)0xF8, 0x00, 0x00};
+    pin_cmd_set(1);
+    spi_wr_mem((char *)bytes, sizeof(bytes));
+
+    CHECK_EQ(panel.memory(120, 120), 0xFFFF);
+    CHECK_EQ(panel.memory(121, 120), 0xF800);
+    CHECK_EQ(panel.stats().pixels, 2);
+}
+
+static void test_hidden_pixels()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+
+    uint32_t hidden = 0;
+    for (uint16_t y = 0; y < PanelEmulator::Height; y++) {
+        for (uint16_t x = 0; x < PanelEmulator::Width; x++) {
+            hidden += !PanelEmulator::visible(x, y);
+        }
+    }
+    // About 21% of the square is behind the bezel
+    CHECK(hidden > 57600 * 20 / 100 && hidden < 57600 * 22 / 100);
+
+    window(0, 0, 239, 239);
+    command(0x2C);
+    pixels(std::vector<uint16_t>(240 * 240, 0x07E0));
+    CHECK_EQ(panel.stats().pixels, 240 * 240);
+    CHECK_EQ(panel.stats().hidden_pixels, hidden);
+}
+
+static void test_scroll()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+
+    window(0, 0, 0, 239);
+    command(0x2C);
+    std::vector<uint16_t> rows;
+    for (uint16_t y = 0; y < 240; y++) {
+        rows.push_back(y);
+    }
+    pixels(rows);
+
+    command(0x33, {0, 0, 0, 240, 0, 0});
+    command(0x37, {0, 10});
+    CHECK_EQ(panel.scroll_start(), 10);
+    CHECK_EQ(panel.shown(0, 0), 10);
+    CHECK_EQ(panel.shown(0, 229), 239);
+    CHECK_EQ(panel.shown(0, 230), 0);
+
+    // A fixed top area does not move
+    command(0x33, {0, 20, 0, 220, 0, 0});
+    command(0x37, {0, 30});
+    CHECK_EQ(panel.shown(0, 19), 19);
+    CHECK_EQ(panel.shown(0, 20), 30);
+    CHECK_EQ(panel.shown(0, 229), 239);
+    CHECK_EQ(panel.shown(0, 230), 20);
+}
+
+static void test_monitor_agrees()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+    PanelMonitor::reset();
+    panel.clear_stats();
+
+    window(10, 10, 29, 19);
+    command(0x2C);
+    pixels(std::vector<uint16_t>(200, 0x1234));
+
+    const PanelMonitor::Stats &stats = PanelMonitor::stats();
+    CHECK_EQ(stats.commands, panel.stats().commands);
+    CHECK_EQ(stats.commands, 3);
+    CHECK_EQ(stats.param_bytes, 8);
+    CHECK_EQ(stats.pixel_bytes, panel.stats().pixels * 2);
+    CHECK_EQ(stats.windows, 1);
+    CHECK_EQ(stats.overruns, 0);
+
+    // 411 bytes at 16 MHz on the 8 bit bus
+    CHECK_EQ(PanelMonitor::bus_time_us(16000000, 8), 411 * 8 / 16);
+    CHECK_EQ(PanelMonitor::bus_time_us(16000000, 9), 411 * 9 / 16);
+
+    spi_set_freq(32000000);
+    CHECK_EQ(host_spi_freq(), 32000000);
+}
+
+static uint32_t transfers_done = 0;
+
+static void count_done()
+{
+    transfers_done++;
+}
+
+static void test_held_transfer()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+    transfers_done = 0;
+
+    char bytes[4] = {0x12, 0x34, 0x56, 0x78};
+    window(0, 120, 1, 120);
+    command(0x2C);
+    pin_cmd_set(1);
+
+    host_hal_hold_transfers(true);
+    spi_wr_mem_async(bytes, sizeof(bytes), count_done);
+    CHECK_EQ(transfers_done, 0);
+    CHECK_EQ(panel.memory(1, 120), 0x5678);
+    CHECK(host_hal_complete());
+    CHECK_EQ(transfers_done, 1);
+    CHECK(!host_hal_complete());
+
+    host_hal_hold_transfers(false);
+    spi_wr_mem_async(bytes, sizeof(bytes), count_done);
+    CHECK_EQ(transfers_done, 2);
+}
+
+static void test_ppm()
+{
+    init();
+    PanelEmulator &panel = host_panel();
+
+    // Red top half, blue bottom half
+    window(0, 0, 239, 239);
+    command(0x2C);
+    std::vector<uint16_t> frame(240 * 240, 0xF800);
+    std::fill(frame.begin() + 240 * 120, frame.end(), 0x001F);
+    pixels(frame);
+
+    const char *path = "PanelEmulatorTest.ppm";
+    CHECK(panel.write_ppm(path));
+
+    FILE *f = fopen(path, "rb");
+    CHECK(f != NULL);
+    if (!f) {
+        return;
+    }
+    char header[16] = {0};
+    CHECK(fread(header, 1, 15, f) == 15);
+    CHECK(memcmp(header, "P6\n240 240\n255\n", 15) == 0);
+
+    std::vector<uint8_t> rgb(240 * 240 * 3);
+    CHECK_EQ(fread(rgb.data(), 1, rgb.size(), f), rgb.size());
+    fclose(f);
+
+    const uint8_t *top = &rgb[(60 * 240 + 120) * 3];
+    const uint8_t *bottom = &rgb[(180 * 240 + 120) * 3];
+    const uint8_t *corner = &rgb[0];
+    CHECK(top[0] == 255 && top[1] == 0 && top[2] == 0);
+    CHECK(bottom[0] == 0 && bottom[1] == 0 && bottom[2] == 255);
+    CHECK(corner[0] == 0x40 && corner[1] == 0x40 && corner[2] == 0x40);
+}
+
+int main()
+{
+    test_power();
+    test_window_write();
+    test_madctl();
+    test_18_bit();
+    test_hidden_pixels();
+    test_scroll();
+    test_monitor_agrees();
+    test_held_transfer();
+    test_ppm();
+
+    return test_result("PanelEmulatorTest");
+}
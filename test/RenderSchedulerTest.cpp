@@ -0,0 +1,291 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "RenderScheduler.h"
+#include "UiCommandQueue.h"
+#include "HostLvgl.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+// The queue as RenderScheduler sees it: published commands, and producers
+// that have claimed a slot but not yet published it
+static std::vector<mbed::Callback<void()>> published;
+static int claimed = 0;
+
+bool UiCommandQueue::post(mbed::Callback<void()> command)
+{
+    published.push_back(command);
+    RenderScheduler::kick();
+    return true;
+}
+
+uint32_t UiCommandQueue::drain()
+{
+    std::vector<mbed::Callback<void()>> commands;
+    commands.swap(published);
+    for (auto &command : commands) {
+        command();
+    }
+    return commands.size();
+}
+
+bool UiCommandQueue::empty()
+{
+    return published.empty() && claimed == 0;
+}
+
+static uint32_t anim_runs = 0;
+static uint32_t anim_frames = 0;
+
+// Like lv_anim's task: switches itself off once nothing animates
+static void anim_task(lv_task_t *task)
+{
+    anim_runs++;
+    if (anim_frames && --anim_frames == 0) {
+        lv_task_set_prio(task, LV_TASK_PRIO_OFF);
+    }
+}
+
+static lv_color_t buf[LV_HOR_RES_MAX * 10];
+static lv_disp_buf_t disp_buf;
+static lv_disp_drv_t drv;
+
+static void flush_ready(lv_disp_drv_t *d, const lv_area_t *area, lv_color_t *color_p)
+{
+    lv_disp_flush_ready(d);
+}
+
+static lv_task_t *setup()
+{
+    static const HostLayer layers[] = {{{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0x0000, NULL}};
+
+    host_kernel_ms = 0;
+    host_lvgl_reset();
+    host_screen_set(layers, 1);
+    published.clear();
+    claimed = 0;
+    anim_runs = 0;
+    anim_frames = 0;
+
+    lv_disp_drv_init(&drv);
+    lv_disp_buf_init(&disp_buf, buf, NULL, LV_HOR_RES_MAX * 10);
+    drv.buffer = &disp_buf;
+    drv.flush_cb = flush_ready;
+    lv_disp_drv_register(&drv);
+
+    return lv_task_create(anim_task, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_OFF, NULL);
+}
+
+static void invalidate()
+{
+    lv_area_t area;
+    lv_area_set(&area, 0, 0, 9, 9);
+    _lv_inv_area(lv_disp_get_default(), &area);
+    RenderScheduler::kick();
+}
+
+/**
+ * Nothing is scheduled while nothing is due, a change is drawn when the
+ * refresh period allows.
+ */
+static void test_idle()
+{
+    events::EventQueue queue;
+    RenderScheduler scheduler(queue);
+    setup();
+
+    host_kernel_ms = 1000;
+    scheduler.start();
+    queue.dispatch(0);
+    CHECK_EQ(host_refr_stats().refreshes, 1u);
+    CHECK_EQ(queue.pending(), 0);
+
+    uint32_t dispatched = queue.dispatched();
+    queue.dispatch(600000);
+    CHECK_EQ(queue.dispatched(), dispatched);
+
+    // Early in the refresh period: run now, draw when the period is up
+    lv_disp_get_default()->refr_task->last_run = lv_tick_get() - 10;
+    invalidate();
+    queue.dispatch(0);
+    CHECK_EQ(host_refr_stats().refreshes, 1u);
+    CHECK_EQ(queue.pending(), 1);
+
+    queue.dispatch(19);
+    CHECK_EQ(host_refr_stats().refreshes, 1u);
+    queue.dispatch(1);
+    CHECK_EQ(host_refr_stats().refreshes, 2u);
+    CHECK_EQ(queue.pending(), 0);
+}
+
+/**
+ * A producer that has claimed a slot but not published it yet leaves the
+ * queue not empty with nothing to drain. The scheduler must not spin on
+ * the event queue until it is published.
+ */
+static void test_unpublished_command()
+{
+    events::EventQueue queue;
+    RenderScheduler scheduler(queue);
+    setup();
+
+    scheduler.start();
+    queue.dispatch(0);
+
+    claimed = 1;
+    invalidate();
+    uint32_t dispatched = queue.dispatched();
+    queue.dispatch(1000);
+    CHECK(queue.dispatched() - dispatched <= 2);
+    CHECK_EQ(queue.pending(), 0);
+
+    // Publishing kicks
+    int ran = 0;
+    claimed = 0;
+    UiCommandQueue::post([&ran]() { ran++; });
+    queue.dispatch(0);
+    CHECK_EQ(ran, 1);
+    CHECK_EQ(queue.pending(), 0);
+
+    // A command posting another from the drain is run by the next wakeup
+    UiCommandQueue::post([&ran]() { UiCommandQueue::post([&ran]() { ran++; }); });
+    queue.dispatch(0);
+    CHECK_EQ(ran, 2);
+    CHECK_EQ(queue.pending(), 0);
+}
+
+/**
+ * A run that cannot be queued is counted, and the next kick brings the
+ * animation back.
+ */
+static void test_queue_full()
+{
+    events::EventQueue queue;
+    RenderScheduler scheduler(queue);
+    lv_task_t *anim = setup();
+
+    scheduler.start();
+    queue.dispatch(0);
+    lv_task_set_prio(anim, LV_TASK_PRIO_MID);
+    RenderScheduler::kick();
+    queue.dispatch(100);
+    uint32_t runs = anim_runs;
+    CHECK(runs >= 3);
+
+    // The run that would queue the next frame finds no room
+    queue.set_full(true);
+    queue.dispatch(LV_DISP_DEF_REFR_PERIOD);
+    CHECK_EQ(scheduler.missed_runs(), 1u);
+    CHECK_EQ(queue.pending(), 0);
+
+    // Kicks while full are counted too and change nothing
+    RenderScheduler::kick();
+    CHECK_EQ(scheduler.missed_runs(), 2u);
+    queue.set_full(false);
+    queue.dispatch(1000);
+    runs = anim_runs;
+
+    UiCommandQueue::post([]() {});
+    queue.dispatch(10 * LV_DISP_DEF_REFR_PERIOD);
+    CHECK(anim_runs >= runs + 10);
+    CHECK_EQ(queue.pending(), 1);
+}
+
+/**
+ * wakeups_per_minute() reports the last full minute, also when the watch
+ * has been idle since.
+ */
+static void test_wakeups_per_minute()
+{
+    events::EventQueue queue;
+    RenderScheduler scheduler(queue);
+    lv_task_t *anim = setup();
+
+    scheduler.start();
+    queue.dispatch(0);
+    CHECK_EQ(scheduler.wakeups_per_minute(), 0u);
+
+    // Animate for most of the first minute, then stop
+    anim_frames = 1000;
+    lv_task_set_prio(anim, LV_TASK_PRIO_MID);
+    RenderScheduler::kick();
+    queue.dispatch(59000);
+    CHECK_EQ(anim_frames, 0u);
+    CHECK_EQ(queue.pending(), 0);
+    CHECK_EQ(scheduler.wakeups_per_minute(), 0u);
+
+    queue.dispatch(1000);
+    uint32_t busy = scheduler.wakeups_per_minute();
+    CHECK(busy >= 1000 && busy <= 1002);
+
+    // Still the busy minute half a minute later, then the idle one
+    queue.dispatch(30000);
+    CHECK_EQ(scheduler.wakeups_per_minute(), busy);
+    queue.dispatch(30000);
+    CHECK_EQ(scheduler.wakeups_per_minute(), 0u);
+
+    // After hours of sleep, one wakeup 10 s into a minute
+    queue.dispatch(3 * 3600000 + 10000);
+    invalidate();
+    queue.dispatch(49000);
+    CHECK_EQ(scheduler.wakeups_per_minute(), 0u);
+    queue.dispatch(1000);
+    CHECK_EQ(scheduler.wakeups_per_minute(), 1u);
+}
+
+/**
+ * Held, kicks run commands but not the task handler.
+ */
+static void test_held()
+{
+    events::EventQueue queue;
+    RenderScheduler scheduler(queue);
+    setup();
+
+    scheduler.start();
+    queue.dispatch(0);
+    uint32_t runs = host_refr_runs;
+
+    RenderScheduler::hold();
+    invalidate();
+    CHECK_EQ(queue.pending(), 0);
+
+    int ran = 0;
+    UiCommandQueue::post([&ran]() { ran++; });
+    queue.dispatch(100);
+    CHECK_EQ(ran, 1);
+    CHECK_EQ(host_refr_runs, runs);
+
+    RenderScheduler::release();
+    queue.dispatch(100);
+    CHECK(host_refr_runs > runs);
+    CHECK_EQ(lv_disp_get_default()->inv_p, 0u);
+}
+
+int main()
+{
+    test_idle();
+    test_unpublished_command();
+    test_queue_full();
+    test_wakeups_per_minute();
+    test_held();
+
+    return test_result("RenderSchedulerTest");
+}
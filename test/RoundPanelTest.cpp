@@ -0,0 +1,215 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "RoundPanel.h"
+#include "HostLvgl.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+// A pixel is on the glass when its centre is inside the circle
+static bool visible(int x, int y)
+{
+    double r = LV_HOR_RES_MAX / 2.0;
+    double dx = x + 0.5 - r;
+    double dy = y + 0.5 - r;
+    return dx * dx + dy * dy <= r * r;
+}
+
+static bool any_visible(const lv_area_t &area)
+{
+    for (int y = area.y1; y <= area.y2; y++) {
+        for (int x = area.x1; x <= area.x2; x++) {
+            if (x >= 0 && x < LV_HOR_RES_MAX && y >= 0 && y < LV_VER_RES_MAX && visible(x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void test_rows()
+{
+    for (int y = 0; y < LV_VER_RES_MAX; y++) {
+        int first = 0;
+        while (first < LV_HOR_RES_MAX && !visible(first, y)) {
+            first++;
+        }
+        int last = LV_HOR_RES_MAX - 1;
+        while (last >= 0 && !visible(last, y)) {
+            last--;
+        }
+
+        CHECK_EQ(RoundPanel::row_start(y), first);
+        CHECK_EQ(RoundPanel::row_end(y), last);
+        CHECK_EQ(RoundPanel::row_start(y), RoundPanel::row_start(LV_VER_RES_MAX - 1 - y));
+    }
+
+    CHECK_EQ(RoundPanel::row_start(LV_VER_RES_MAX / 2), 0);
+    CHECK_EQ(RoundPanel::row_end(LV_VER_RES_MAX / 2), LV_HOR_RES_MAX - 1);
+    CHECK(RoundPanel::row_start(0) > 100);
+}
+
+static void test_clip_area()
+{
+    lv_area_t area;
+
+    lv_area_set(&area, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    CHECK(RoundPanel::clip_area(area));
+    CHECK_EQ(area.x1, 0);
+    CHECK_EQ(area.x2, LV_HOR_RES_MAX - 1);
+    CHECK_EQ(area.y1, 0);
+    CHECK_EQ(area.y2, LV_VER_RES_MAX - 1);
+
+    // Top band: the widest row is its lowest one
+    lv_area_set(&area, 0, 0, LV_HOR_RES_MAX - 1, 9);
+    CHECK(RoundPanel::clip_area(area));
+    CHECK_EQ(area.x1, RoundPanel::row_start(9));
+    CHECK_EQ(area.x2, RoundPanel::row_end(9));
+
+    // All in the top left corner, left untouched
+    lv_area_set(&area, 0, 0, 20, 20);
+    CHECK(!RoundPanel::clip_area(area));
+    CHECK_EQ(area.x1, 0);
+    CHECK_EQ(area.x2, 20);
+    CHECK_EQ(area.y2, 20);
+
+    // Left strip loses the rows that only cover the corners
+    lv_area_set(&area, 0, 0, 9, LV_VER_RES_MAX - 1);
+    CHECK(RoundPanel::clip_area(area));
+    CHECK(RoundPanel::row_start(area.y1) <= 9);
+    CHECK(RoundPanel::row_start(area.y1 - 1) > 9);
+    CHECK_EQ(area.y2, LV_VER_RES_MAX - 1 - area.y1);
+    CHECK_EQ(area.x1, 0);
+    CHECK_EQ(area.x2, 9);
+}
+
+static void test_clip_keeps_visible_pixels()
+{
+    srand(1);
+    for (int n = 0; n < 5000; n++) {
+        lv_area_t area;
+        lv_coord_t x1 = rand() % LV_HOR_RES_MAX;
+        lv_coord_t y1 = rand() % LV_VER_RES_MAX;
+        lv_area_set(&area, x1, y1, x1 + rand() % (LV_HOR_RES_MAX - x1), y1 + rand() % (LV_VER_RES_MAX - y1));
+
+        lv_area_t clipped = area;
+        bool hit = RoundPanel::clip_area(clipped);
+
+        CHECK_EQ(hit, any_visible(area));
+        if (!hit) {
+            CHECK(memcmp(&clipped, &area, sizeof(area)) == 0);
+            continue;
+        }
+
+        // Only ever shrinks, and nothing visible is cut off
+        CHECK(clipped.x1 >= area.x1 && clipped.x2 <= area.x2);
+        CHECK(clipped.y1 >= area.y1 && clipped.y2 <= area.y2);
+        for (int y = area.y1; y <= area.y2; y++) {
+            for (int x = area.x1; x <= area.x2; x++) {
+                if (visible(x, y) && (x < clipped.x1 || x > clipped.x2 || y < clipped.y1 || y > clipped.y2)) {
+                    CHECK(!"visible pixel clipped");
+                    y = area.y2;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void test_rounder()
+{
+    lv_disp_drv_t drv;
+    lv_area_t area;
+
+    memset(&drv, 0, sizeof(drv));
+
+    lv_area_set(&area, 0, 0, LV_HOR_RES_MAX - 1, 9);
+    RoundPanel::rounder_cb(&drv, &area);
+    CHECK_EQ(area.x1, RoundPanel::row_start(9));
+    CHECK_EQ(area.x2, RoundPanel::row_end(9));
+
+    // A rounder cannot return an empty area, corners go through as they are
+    lv_area_set(&area, 0, 0, 20, 20);
+    RoundPanel::rounder_cb(&drv, &area);
+    CHECK_EQ(area.x1, 0);
+    CHECK_EQ(area.x2, 20);
+
+    RoundPanel::set_rounder_enabled(false);
+    lv_area_set(&area, 0, 0, LV_HOR_RES_MAX - 1, 9);
+    RoundPanel::rounder_cb(&drv, &area);
+    CHECK_EQ(area.x1, 0);
+    CHECK_EQ(area.x2, LV_HOR_RES_MAX - 1);
+    RoundPanel::set_rounder_enabled(true);
+}
+
+static void flush_ready(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    lv_disp_flush_ready(drv);
+}
+
+/**
+ * The rounder must not change how high LVGL makes its strips. lv_refr_area()
+ * rounds a one column probe at x = 0 from row 0 to find out.
+ */
+static void test_strip_height()
+{
+    for (lv_coord_t h = 1; h <= LV_VER_RES_MAX; h++) {
+        lv_disp_drv_t drv;
+        lv_area_t probe;
+        memset(&drv, 0, sizeof(drv));
+        lv_area_set(&probe, 0, 0, 0, h - 1);
+        RoundPanel::rounder_cb(&drv, &probe);
+        CHECK_EQ(probe.y2, h - 1);
+    }
+
+    static const lv_coord_t lines[] = {10, 40, 120, LV_VER_RES_MAX};
+    static const HostLayer layers[] = {{{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0x1234, NULL}};
+
+    for (lv_coord_t rows : lines) {
+        std::vector<lv_color_t> buf((size_t)LV_HOR_RES_MAX * rows);
+        lv_disp_buf_t disp_buf;
+        lv_disp_drv_t drv;
+
+        host_lvgl_reset();
+        host_screen_set(layers, 1);
+        lv_disp_drv_init(&drv);
+        lv_disp_buf_init(&disp_buf, buf.data(), NULL, LV_HOR_RES_MAX * rows);
+        drv.buffer = &disp_buf;
+        drv.flush_cb = flush_ready;
+        drv.rounder_cb = &RoundPanel::rounder_cb;
+        lv_refr_now(lv_disp_drv_register(&drv));
+
+        CHECK_EQ(host_refr_stats().max_rows, rows);
+        CHECK_EQ(host_refr_stats().strips, (uint32_t)(LV_VER_RES_MAX + rows - 1) / rows);
+    }
+}
+
+int main()
+{
+    RoundPanel::init();
+
+    test_rows();
+    test_clip_area();
+    test_clip_keeps_visible_pixels();
+    test_rounder();
+    test_strip_height();
+
+    return test_result("RoundPanelTest");
+}
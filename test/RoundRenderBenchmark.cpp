@@ -0,0 +1,189 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "lv_drv_conf.h"
+#include "DisplayFlush.h"
+#include "RoundPanel.h"
+#include "HostHal.h"
+#include "HostLvgl.h"
+#include "PanelMonitor.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+/**
+ * lv_refr time of typical redraws with GC9A01_RENDER_ROUND on and off.
+ *
+ * With the mode on RoundPanel::rounder_cb trims every invalidated area to
+ * the disc before LVGL draws it. Each redraw goes through the host refresh,
+ * DisplayFlush and the emulator, with the draw buffers of lv_drv_conf.h and
+ * with a full frame buffer. Reported are the strips and pixels drawn, the
+ * bus time at GC9A01_SPI_BAUD, the host time of lv_refr_now() and the
+ * render time modelled at RenderNsPerPx, or the ns per pixel given as the
+ * first argument.
+ *
+ * Fails when the mode draws more, or cuts a redraw into more strips, than
+ * without it, or draws as much for a redraw reaching behind the bezel. The bytes sent can go
+ * up a little with the mode on: rows of a narrower area save less by
+ * leaving out the bezel, so more of them go out full width.
+ */
+
+static constexpr uint32_t RenderNsPerPx = 250;
+
+struct Redraw
+{
+    const char *name;
+    lv_area_t area;
+    bool corner;    // partly behind the bezel
+};
+
+struct Result
+{
+    uint32_t strips;
+    uint32_t drawn_px;
+    uint32_t bytes;
+    uint32_t bus_us;
+    double host_us;
+};
+
+static uint16_t face(lv_coord_t x, lv_coord_t y)
+{
+    return (uint16_t)((x * 31 / 239) << 11 | (y * 63 / 239) << 5 | ((x ^ y) & 0x1F));
+}
+
+// A black screen under a full screen image, the watch face
+static const HostLayer layers[] = {
+    {{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0x0000, NULL},
+    {{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0, face},
+};
+
+static events::EventQueue queue;
+
+static Result redraw(const lv_area_t &area, lv_coord_t lines, bool two, bool round)
+{
+    std::vector<lv_color_t> buf1((size_t)LV_HOR_RES_MAX * lines);
+    std::vector<lv_color_t> buf2(two ? buf1.size() : 0);
+    lv_disp_buf_t disp_buf;
+    lv_disp_drv_t drv;
+    DisplayFlush flush(queue);
+
+    host_hal_reset();
+    host_lvgl_reset();
+    host_screen_set(layers, sizeof(layers) / sizeof(layers[0]));
+    RoundPanel::set_rounder_enabled(true);
+
+    lv_disp_drv_init(&drv);
+    lv_disp_buf_init(&disp_buf, buf1.data(), two ? buf2.data() : NULL, LV_HOR_RES_MAX * lines);
+    drv.buffer = &disp_buf;
+    if (round) {
+        drv.rounder_cb = &RoundPanel::rounder_cb;
+    }
+    flush.start(drv);
+    lv_disp_t *disp = lv_disp_drv_register(&drv);
+
+    const uint8_t colmod = 0x55;
+    flush.write_command(0x11, nullptr, 0);
+    flush.write_command(0x3A, &colmod, 1);
+    flush.write_command(0x29, nullptr, 0);
+    lv_refr_now(disp);
+    flush.write_command(0x00, nullptr, 0);
+
+    // The measured redraw
+    HostRefrStats before = host_refr_stats();
+    PanelMonitor::reset();
+    _lv_inv_area(disp, &area);
+    auto start = std::chrono::steady_clock::now();
+    lv_refr_now(disp);
+    flush.write_command(0x00, nullptr, 0);
+    auto end = std::chrono::steady_clock::now();
+
+    const HostRefrStats &after = host_refr_stats();
+    Result result;
+    result.strips = after.strips - before.strips;
+    result.drawn_px = (after.pattern_px + after.software_px + after.gpu_px) -
+        (before.pattern_px + before.software_px + before.gpu_px);
+    result.bytes = PanelMonitor::stats().pixel_bytes;
+    result.bus_us = PanelMonitor::bus_time_us(GC9A01_SPI_BAUD, 8);
+    result.host_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+    // What the glass shows does not depend on the mode
+    const PanelEmulator &panel = host_panel();
+    for (lv_coord_t y = area.y1; y <= area.y2; y++) {
+        for (lv_coord_t x = area.x1; x <= area.x2; x++) {
+            if (PanelEmulator::visible(x, y) && panel.memory(x, y) != face(x, y)) {
+                CHECK_EQ(panel.memory(x, y), face(x, y));
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    // A whole face, the status icons along the top, a corner icon, a line of
+    // text near the bottom and the time in the middle
+    static const Redraw redraws[] = {
+        {"watch face", {0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, false},
+        {"status bar", {0, 0, LV_HOR_RES_MAX - 1, 31}, true},
+        {"corner icon", {176, 16, 231, 47}, true},
+        {"bottom text", {0, 200, LV_HOR_RES_MAX - 1, 235}, true},
+        {"time", {60, 96, 179, 143}, false},
+    };
+    struct Buffers
+    {
+        const char *name;
+        lv_coord_t lines;
+        bool two;
+    };
+    static const Buffers buffers[] = {
+        {"config", GC9A01_BUF_MODE == GC9A01_BUF_FULL ? LV_VER_RES_MAX : GC9A01_BUF_LINES,
+            GC9A01_BUF_MODE == GC9A01_BUF_DOUBLE},
+        {"full", LV_VER_RES_MAX, false},
+    };
+
+    uint32_t ns_per_px = (argc > 1) ? (uint32_t)atoi(argv[1]) : RenderNsPerPx;
+    RoundPanel::init();
+
+    printf("render %u ns/px, SPI %u Hz\n", ns_per_px, (unsigned)GC9A01_SPI_BAUD);
+    printf("%-6s %-11s %-5s %6s %8s %7s %9s %9s %8s\n", "buffer", "redraw", "round", "strips", "drawn px",
+        "bytes", "render us", "bus us", "host us");
+
+    for (const Buffers &b : buffers) {
+        for (const Redraw &r : redraws) {
+            Result results[2];
+            for (int on = 0; on < 2; on++) {
+                Result &res = results[on];
+                res = redraw(r.area, b.lines, b.two, on);
+                printf("%-6s %-11s %-5s %6u %8u %7u %9u %9u %8.0f\n", b.name, r.name, on ? "on" : "off",
+                    res.strips, res.drawn_px, res.bytes, (unsigned)((uint64_t)res.drawn_px * ns_per_px / 1000),
+                    res.bus_us, res.host_us);
+            }
+
+            CHECK(results[1].drawn_px <= results[0].drawn_px);
+            CHECK(results[1].strips <= results[0].strips);
+            if (r.corner) {
+                CHECK(results[1].drawn_px < results[0].drawn_px);
+            }
+        }
+    }
+
+    return test_result("RoundRenderBenchmark");
+}
@@ -0,0 +1,294 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "lv_drv_conf.h"
+#include "ScrollTransition.h"
+#include "RenderScheduler.h"
+#include "RoundPanel.h"
+#include "HostHal.h"
+#include "HostLvgl.h"
+#include "PanelMonitor.h"
+#include "TestCheck.h"
+
+using namespace Mytime::Controllers;
+
+// ScrollTransition::Rows, StepRows and FrameMs
+static const lv_coord_t Rows = LV_VER_RES_MAX;
+static const lv_coord_t StepRows = 24;
+static const int FrameMs = 16;
+static const uint32_t StripBytes = StepRows * LV_HOR_RES_MAX * sizeof(lv_color_t);
+static const uint32_t FrameBytes = LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(lv_color_t);
+
+// Stands in for the scheduler, the test drives every refresh itself
+static int holds = 0;
+static int releases = 0;
+static bool suspended = false;
+
+void RenderScheduler::kick() {}
+void RenderScheduler::hold() { holds++; }
+void RenderScheduler::release() { releases++; }
+bool RenderScheduler::is_suspended() { return suspended; }
+
+static events::EventQueue queue;
+static DisplayFlush flush(queue);
+static ScrollTransition scroll(queue, flush);
+static lv_disp_buf_t disp_buf;
+static lv_color_t buf1[LV_HOR_RES_MAX * GC9A01_BUF_LINES];
+static lv_color_t buf2[LV_HOR_RES_MAX * GC9A01_BUF_LINES];
+static lv_disp_drv_t drv;
+static lv_disp_t *disp;
+
+static uint16_t old_screen(lv_coord_t x, lv_coord_t y)
+{
+    return (uint16_t)((x * 31 / 239) << 11 | (y & 0x3F) << 5 | 0x03);
+}
+
+static uint16_t new_screen(lv_coord_t x, lv_coord_t y)
+{
+    return (uint16_t)(0x1F << 11 | (y & 0x3F) << 5 | ((x ^ y) & 0x1F));
+}
+
+static const HostLayer old_layers[] = {{{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0, old_screen}};
+static const HostLayer new_layers[] = {{{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0, new_screen}};
+
+/**
+ * The panel and LVGL as main.cpp sets them up, showing the old screen.
+ */
+static void setup()
+{
+    host_hal_reset();
+    host_lvgl_reset();
+    RoundPanel::init();
+    RoundPanel::set_rounder_enabled(true);
+    suspended = false;
+    holds = 0;
+    releases = 0;
+
+    lv_disp_drv_init(&drv);
+    lv_disp_buf_init(&disp_buf, buf1, buf2, LV_HOR_RES_MAX * GC9A01_BUF_LINES);
+    drv.buffer = &disp_buf;
+    drv.rounder_cb = &RoundPanel::rounder_cb;
+    flush.start(drv);
+    disp = lv_disp_drv_register(&drv);
+    scroll.start();
+
+    const uint8_t colmod = 0x55;
+    flush.write_command(0x11, nullptr, 0);
+    flush.write_command(0x3A, &colmod, 1);
+    flush.write_command(0x29, nullptr, 0);
+
+    host_screen_set(old_layers, 1);
+    lv_refr_now(disp);
+    flush.write_command(0x00, nullptr, 0);
+}
+
+/**
+ * Change the screen like lv_scr_load() does, the slide must start before
+ * the next refresh.
+ */
+static void load_new_screen()
+{
+    host_screen_set(new_layers, 1);
+    lv_obj_invalidate(lv_scr_act());
+}
+
+/**
+ * The glass after revealed rows came in: the new screen's first or last
+ * rows at the edge it comes from, the old one pushed the other way.
+ */
+static bool glass_shows(ScrollTransition::Direction direction, lv_coord_t revealed)
+{
+    const PanelEmulator &panel = host_panel();
+    for (lv_coord_t d = 0; d < Rows; d++) {
+        bool incoming;
+        lv_coord_t row;
+        if (direction == ScrollTransition::Up) {
+            incoming = d >= Rows - revealed;
+            row = incoming ? d - (Rows - revealed) : d + revealed;
+        } else {
+            incoming = d < revealed;
+            row = incoming ? Rows - revealed + d : d - revealed;
+        }
+
+        for (lv_coord_t x = 0; x < LV_HOR_RES_MAX; x++) {
+            if (!PanelEmulator::visible(x, d)) {
+                continue;
+            }
+            // The old screen was sent round, its rows end where they were drawn
+            if (!incoming && !PanelEmulator::visible(x, row)) {
+                continue;
+            }
+            uint16_t want = incoming ? new_screen(x, row) : old_screen(x, row);
+            if (panel.shown(x, d) != want) {
+                printf("line %d pixel %d shows %04x, not %s row %d %04x\n", d, x, panel.shown(x, d),
+                    incoming ? "new" : "old", row, want);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_slide(ScrollTransition::Direction direction)
+{
+    setup();
+    bool round = flush.round();
+    load_new_screen();
+
+    CHECK(ScrollTransition::slide(direction));
+    CHECK(ScrollTransition::active());
+    CHECK_EQ(holds, 1);
+    CHECK(!flush.round());
+    CHECK(!RoundPanel::rounder_enabled());
+
+    lv_coord_t revealed = 0;
+    for (int step = 0; ScrollTransition::active() && step < 100; step++) {
+        uint32_t sent = flush.bytes_sent();
+        queue.dispatch(step ? FrameMs : 0);
+        revealed = LV_MATH_MIN(revealed + StepRows, Rows);
+
+        // Only the strip that came in was drawn and sent
+        CHECK_EQ(flush.bytes_sent() - sent, StripBytes);
+        if (ScrollTransition::active()) {
+            CHECK(glass_shows(direction, revealed));
+            uint16_t start = (direction == ScrollTransition::Up) ? revealed : (Rows - revealed) % Rows;
+            CHECK_EQ(host_panel().scroll_start(), start);
+        }
+    }
+
+    CHECK_EQ(revealed, Rows);
+    CHECK(!ScrollTransition::active());
+    CHECK_EQ(host_panel().scroll_start(), 0);
+    CHECK(glass_shows(direction, Rows));
+    CHECK_EQ(releases, 1);
+    CHECK_EQ(flush.round(), round);
+    CHECK(RoundPanel::rounder_enabled());
+    CHECK_EQ(disp->inv_p, 0);
+    CHECK_EQ(queue.pending(), 0);
+    CHECK_EQ(host_panel().stats().overruns, 0);
+}
+
+static void test_stop()
+{
+    setup();
+    load_new_screen();
+
+    CHECK(ScrollTransition::slide(ScrollTransition::Down));
+    queue.dispatch(0);
+    queue.dispatch(FrameMs);
+    queue.dispatch(FrameMs);
+    CHECK(glass_shows(ScrollTransition::Down, 3 * StepRows));
+
+    ScrollTransition::stop();
+    CHECK(!ScrollTransition::active());
+    CHECK_EQ(host_panel().scroll_start(), 0);
+    CHECK_EQ(releases, 1);
+    CHECK_EQ(queue.pending(), 0);
+
+    // Cut short, the whole screen is invalidated for the next refresh
+    CHECK_EQ(disp->inv_p, 1);
+    CHECK_EQ(lv_area_get_size(&disp->inv_areas[0]), (uint32_t)LV_HOR_RES_MAX * LV_VER_RES_MAX);
+    lv_refr_now(disp);
+    flush.write_command(0x00, nullptr, 0);
+    CHECK(glass_shows(ScrollTransition::Down, Rows));
+
+    // Nothing left to stop
+    ScrollTransition::stop();
+    CHECK_EQ(releases, 1);
+}
+
+static void test_suspend_ends_slide()
+{
+    setup();
+    load_new_screen();
+
+    CHECK(ScrollTransition::slide(ScrollTransition::Up));
+    queue.dispatch(0);
+    suspended = true;
+    queue.dispatch(FrameMs);
+    CHECK(!ScrollTransition::active());
+    CHECK_EQ(host_panel().scroll_start(), 0);
+    CHECK_EQ(releases, 1);
+
+    // No slide while suspended
+    CHECK(!ScrollTransition::slide(ScrollTransition::Up));
+    CHECK_EQ(holds, 1);
+}
+
+static lv_coord_t soft_offset;
+
+// Both screens moved soft_offset rows up, the new one coming in from below
+static uint16_t soft_slide(lv_coord_t x, lv_coord_t y)
+{
+    lv_coord_t row = y + soft_offset;
+    return (row < Rows) ? old_screen(x, row) : new_screen(x, row - Rows);
+}
+
+/**
+ * Bytes and bus time per frame of the hardware scroll and of a slide that
+ * moves both screens in LVGL and redraws the whole frame every step.
+ */
+static void test_compare_software_slide()
+{
+    setup();
+    load_new_screen();
+    PanelMonitor::reset();
+    CHECK(ScrollTransition::slide(ScrollTransition::Up));
+    int frames = 0;
+    for (; ScrollTransition::active() && frames < 100; frames++) {
+        queue.dispatch(frames ? FrameMs : 0);
+    }
+    uint32_t hw_bytes = PanelMonitor::stats().pixel_bytes / frames;
+    uint32_t hw_us = PanelMonitor::bus_time_us(GC9A01_SPI_BAUD, 8) / frames;
+
+    setup();
+    static const HostLayer soft_layers[] = {{{0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1}, 0, soft_slide}};
+    host_screen_set(soft_layers, 1);
+    PanelMonitor::reset();
+    for (int f = 1; f <= frames; f++) {
+        soft_offset = (lv_coord_t)LV_MATH_MIN(f * StepRows, Rows);
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(disp);
+    }
+    flush.write_command(0x00, nullptr, 0);
+    CHECK(glass_shows(ScrollTransition::Up, Rows));
+    uint32_t sw_bytes = PanelMonitor::stats().pixel_bytes / frames;
+    uint32_t sw_us = PanelMonitor::bus_time_us(GC9A01_SPI_BAUD, 8) / frames;
+
+    // A frame is never shown faster than the slide's own pace
+    uint32_t hw_fps = 1000000 / LV_MATH_MAX(hw_us, (uint32_t)FrameMs * 1000);
+    uint32_t sw_fps = 1000000 / LV_MATH_MAX(sw_us, (uint32_t)FrameMs * 1000);
+    printf("slide, %d frames at %d Hz, bus time only:\n", frames, GC9A01_SPI_BAUD);
+    printf("  hardware scroll: %u bytes/frame, %u us/frame, %u fps\n", hw_bytes, hw_us, hw_fps);
+    printf("  software slide:  %u bytes/frame, %u us/frame, %u fps\n", sw_bytes, sw_us, sw_fps);
+
+    CHECK_EQ(hw_bytes, StripBytes);
+    CHECK(sw_bytes > FrameBytes * 3 / 4);
+    CHECK(hw_fps > sw_fps);
+}
+
+int main()
+{
+    test_slide(ScrollTransition::Up);
+    test_slide(ScrollTransition::Down);
+    test_stop();
+    test_suspend_ends_slide();
+    test_compare_software_slide();
+
+    CHECK(host_panel().write_ppm("ScrollTransitionTest.ppm"));
+    return test_result("ScrollTransitionTest");
+}
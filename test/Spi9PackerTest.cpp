@@ -0,0 +1,264 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "Spi9Packer.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+typedef std::vector<uint8_t> Bits;
+
+/**
+ * Output pin that records the data line on each rising clock edge, like the
+ * panel does.
+ */
+struct Pin
+{
+    int level = 0;
+    const Pin *data = nullptr;
+    Bits *sampled = nullptr;
+
+    Pin& operator=(int v)
+    {
+        if (data && !level && v) {
+            sampled->push_back(data->level);
+        }
+        level = v;
+        return *this;
+    };
+};
+
+struct Word
+{
+    uint8_t dc;
+    uint8_t data;
+};
+
+/**
+ * Sends words through the packer the way common.cpp does and keeps the bits
+ * of every transfer.
+ */
+struct Bus
+{
+    Spi9Packer packer;
+    std::vector<Bits> transfers;
+    std::vector<uint32_t> words_per_transfer;
+    uint32_t words = 0;
+
+    void send()
+    {
+        if (packer.bytes() == 0) {
+            return;
+        }
+
+        Bits bits;
+        for (uint32_t i = 0; i < packer.bytes(); i++) {
+            for (int b = 7; b >= 0; b--) {
+                bits.push_back((packer.data()[i] >> b) & 1);
+            }
+        }
+        // Nothing past the bytes sent is ever set
+        for (uint32_t i = packer.bytes(); i < Spi9Packer::Bytes; i++) {
+            CHECK_EQ(packer.data()[i], 0);
+        }
+        transfers.push_back(bits);
+        words_per_transfer.push_back(words);
+        words = 0;
+
+        packer.clear();
+        for (uint32_t i = 0; i < Spi9Packer::Bytes; i++) {
+            CHECK_EQ(packer.data()[i], 0);
+        }
+    };
+
+    void put(uint8_t dc, uint8_t data)
+    {
+        words++;
+        if (packer.put(dc, data)) {
+            CHECK_EQ(packer.bytes(), Spi9Packer::Bytes);
+            CHECK_EQ(words, Spi9Packer::Bytes * 8 / 9);
+            send();
+        }
+    };
+
+    // spi_wr(): one word, sent straight away
+    void wr(uint8_t dc, uint8_t data)
+    {
+        put(dc, data);
+        send();
+    };
+
+    // spi_wr_mem(): a run of data words, then sent
+    void wr_mem(const std::vector<uint8_t> &data)
+    {
+        for (uint8_t d : data) {
+            put(1, d);
+        }
+        send();
+    };
+};
+
+static Bits bitbang(const std::vector<Word> &words)
+{
+    Bits bits;
+    Pin mosi;
+    Pin sck;
+    sck.data = &mosi;
+    sck.sampled = &bits;
+
+    for (const Word &w : words) {
+        Spi9Packer::bitbang(sck, mosi, w.dc, w.data);
+    }
+    return bits;
+}
+
+/**
+ * The packed transfers carry the same bits as the bit-banged words, each
+ * padded with fewer than 8 zero bits.
+ */
+static void check_stream(const Bus &bus, const std::vector<Word> &words)
+{
+    Bits reference = bitbang(words);
+    CHECK_EQ(reference.size(), words.size() * 9);
+
+    size_t pos = 0;
+    for (size_t t = 0; t < bus.transfers.size(); t++) {
+        const Bits &bits = bus.transfers[t];
+        size_t used = bus.words_per_transfer[t] * 9;
+
+        CHECK(bits.size() >= used);
+        CHECK(bits.size() - used < 8);
+        CHECK_EQ(bits.size() % 8, 0);
+
+        for (size_t i = 0; i < used && pos + i < reference.size(); i++) {
+            if (bits[i] != reference[pos + i]) {
+                printf("transfer %zu bit %zu differs\n", t, i);
+                CHECK(bits[i] == reference[pos + i]);
+                break;
+            }
+        }
+        for (size_t i = used; i < bits.size(); i++) {
+            CHECK_EQ(bits[i], 0);
+        }
+        pos += used;
+    }
+    CHECK_EQ(pos, reference.size());
+}
+
+static void test_bitbang_order()
+{
+    // D/C first, then data MSB first
+    Bits bits = bitbang({{1, 0xA5}, {0, 0x01}});
+    const uint8_t expect[] = {1, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+    CHECK_EQ(bits.size(), sizeof(expect));
+    for (size_t i = 0; i < bits.size() && i < sizeof(expect); i++) {
+        CHECK_EQ(bits[i], expect[i]);
+    }
+}
+
+static void test_command_params_pixels()
+{
+    for (uint32_t len = 0; len < 40; len++) {
+        Bus bus;
+        std::vector<Word> words;
+        std::vector<uint8_t> pixels;
+
+        // CASET with its four parameters, then RAMWR and a pixel run
+        const uint8_t caset[] = {0x00, 0x10, 0x00, 0xEF};
+        bus.wr(0, 0x2A);
+        words.push_back({0, 0x2A});
+        for (uint8_t p : caset) {
+            bus.wr(1, p);
+            words.push_back({1, p});
+        }
+        bus.wr(0, 0x2C);
+        words.push_back({0, 0x2C});
+
+        for (uint32_t i = 0; i < len; i++) {
+            pixels.push_back((uint8_t)(i * 37 + 0x80));
+            words.push_back({1, pixels.back()});
+        }
+        bus.wr_mem(pixels);
+
+        check_stream(bus, words);
+        CHECK_EQ(bus.transfers.size(), 6 + (len ? 1 : 0));
+        if (len) {
+            CHECK_EQ(bus.transfers.back().size(), (len * 9 + 7) / 8 * 8);
+        }
+    }
+}
+
+static void test_full_buffers()
+{
+    // Runs that fill the buffer exactly, cross it, and odd lengths past it
+    const uint32_t per_buffer = Spi9Packer::Bytes * 8 / 9;
+    const uint32_t lengths[] = {per_buffer - 1, per_buffer, per_buffer + 1, 2 * per_buffer + 7, 1001};
+
+    for (uint32_t len : lengths) {
+        Bus bus;
+        std::vector<Word> words;
+        std::vector<uint8_t> pixels;
+
+        bus.wr(0, 0x2C);
+        words.push_back({0, 0x2C});
+        for (uint32_t i = 0; i < len; i++) {
+            pixels.push_back((uint8_t)(rand() & 0xFF));
+            words.push_back({1, pixels.back()});
+        }
+        bus.wr_mem(pixels);
+
+        check_stream(bus, words);
+        CHECK_EQ(bus.transfers.size(), 1 + (len + per_buffer - 1) / per_buffer);
+    }
+}
+
+static void test_padding_cleared()
+{
+    // All ones, then a short transfer, must not leave set bits behind
+    Bus bus;
+    std::vector<Word> words;
+    for (uint32_t i = 0; i < 37; i++) {
+        bus.put(1, 0xFF);
+        words.push_back({1, 0xFF});
+    }
+    bus.send();
+    for (uint32_t i = 0; i < 3; i++) {
+        bus.put(0, 0x00);
+        words.push_back({0, 0x00});
+    }
+    bus.send();
+
+    check_stream(bus, words);
+    CHECK_EQ(bus.transfers.back().size(), 32);
+    for (uint8_t bit : bus.transfers.back()) {
+        CHECK_EQ(bit, 0);
+    }
+}
+
+int main()
+{
+    srand(7);
+
+    test_bitbang_order();
+    test_command_params_pixels();
+    test_full_buffers();
+    test_padding_cleared();
+
+    return test_result("Spi9PackerTest");
+}
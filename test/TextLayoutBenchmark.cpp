@@ -0,0 +1,169 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "TextLayout.h"
+#include "TextLayoutCorpus.h"
+#include "BaselineLayout.h"
+#include "HeapCounter.h"
+#include "TestFonts.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Mytime::Windows;
+
+/**
+ * The TextLayoutCorpus on the host, the first screen of every text laid out
+ * by TextLayout and by the word wrap it replaced, see BaselineLayout.h.
+ *
+ * Fails when the layout allocates, looks up more glyphs than the baseline or
+ * more than LookupsPerLine per chord line, when the line breaks differ from
+ * the baseline where both place the same words, or when the whole corpus is
+ * not at least MinSpeedup times faster than the baseline.
+ */
+
+static constexpr int Runs = 200;
+// Warm, the corpus takes up to 9.3 a line from kerning pairs the cache misses
+static constexpr uint32_t LookupsPerLine = 12;
+// About 8 times in a debug build, 10 optimised
+static constexpr double MinSpeedup = 4;
+
+static double now_ns()
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Words of a line record joined by single spaces, like the baseline builds them
+static std::string words_of(const char *txt, const LineRecord &line)
+{
+    std::string joined;
+    std::string word;
+
+    for (uint16_t i = line.offset; i <= line.offset + line.length; i++) {
+        if (i == line.offset + line.length || txt[i] == ' ') {
+            if (!word.empty()) {
+                joined += (joined.empty() ? "" : " ") + word;
+            }
+            word.clear();
+        } else {
+            word += txt[i];
+        }
+    }
+    return joined;
+}
+
+// Both place the same words when no word needs cutting and words are one space apart
+static bool comparable(const char *txt, const GlyphAdvance &glyphs, const ChordTable &lines)
+{
+    if (strstr(txt, "  ")) {
+        return false;
+    }
+    for (const char *word = txt; *word; ) {
+        size_t len = strcspn(word, " ");
+        uint16_t bytes;
+        uint32_t last;
+        if (glyphs.fit(word, len, LV_COORD_MAX, bytes, last) > lines.widest()) {
+            return false;
+        }
+        word += len + (word[len] == ' ');
+    }
+    return true;
+}
+
+int main()
+{
+    static const lv_font_t * const fonts[] = {&test_font_kerned, &test_font_large};
+    static const char * const font_names[] = {"16px", "36px"};
+    static const lv_coord_t diameters[] = {150, 200, 240};
+
+    // The counter must see an allocation, or it is not linked in
+    uint32_t probe = heap_allocs();
+    std::string probe_text(100, 'x');
+    CHECK(heap_allocs() > probe);
+
+    double layout_total = 0;
+    double baseline_total = 0;
+
+    printf("%-4s %3s %-10s %5s %9s %8s %6s %9s %8s %6s %s\n", "font", "d", "text", "lines",
+        "layout ns", "lookups", "allocs", "base ns", "lookups", "allocs", "breaks");
+
+    for (uint8_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+        for (uint8_t d = 0; d < sizeof(diameters) / sizeof(diameters[0]); d++) {
+            const GlyphAdvance glyphs = GlyphAdvance::get(fonts[f], 0);
+            const ChordTable lines = ChordTable::get(diameters[d] / 2, glyphs.line_height());
+
+            for (uint8_t t = 0; t < TextLayoutCorpus::Size; t++) {
+                const char *txt = TextLayoutCorpus::text(t);
+                TextSpan span(txt);
+                TextLayout layout;
+
+                // Warm the pair cache, as on a watch showing notifications
+                layout.layout(span, glyphs, lines);
+
+                uint32_t lookups = host_glyph_lookups;
+                uint32_t allocs = heap_allocs();
+                double start = now_ns();
+                for (int run = 0; run < Runs; run++) {
+                    layout.layout(span, glyphs, lines);
+                }
+                double layout_ns = (now_ns() - start) / Runs;
+                uint32_t layout_lookups = (host_glyph_lookups - lookups) / Runs;
+                uint32_t layout_allocs = (heap_allocs() - allocs) / Runs;
+
+                std::vector<BaselineLine> baseline;
+                lookups = host_glyph_lookups;
+                allocs = heap_allocs();
+                start = now_ns();
+                for (int run = 0; run < Runs; run++) {
+                    baseline = baseline_wrap(txt, fonts[f], 0, lines);
+                }
+                double baseline_ns = (now_ns() - start) / Runs;
+                uint32_t baseline_lookups = (host_glyph_lookups - lookups) / Runs;
+                uint32_t baseline_allocs = (heap_allocs() - allocs) / Runs;
+
+                const char *breaks = "-";
+                if (comparable(txt, glyphs, lines)) {
+                    bool same = baseline.size() == layout.size();
+                    for (uint8_t i = 0; same && i < layout.size(); i++) {
+                        same = baseline[i].text == words_of(txt, layout[i]) && baseline[i].width == layout[i].width;
+                    }
+                    CHECK(same);
+                    breaks = same ? "same" : "DIFFER";
+                }
+
+                printf("%-4s %3d %-10s %5d %9.0f %8u %6u %9.0f %8u %6u %s\n", font_names[f], diameters[d],
+                    TextLayoutCorpus::name(t), layout.size(), layout_ns, layout_lookups, layout_allocs,
+                    baseline_ns, baseline_lookups, baseline_allocs, breaks);
+
+                CHECK_EQ(layout_allocs, 0);
+                CHECK(layout_lookups <= baseline_lookups);
+                CHECK(layout_lookups <= LookupsPerLine * lines.size());
+
+                layout_total += layout_ns;
+                baseline_total += baseline_ns;
+            }
+        }
+    }
+
+    printf("corpus: layout %.0f ns, baseline %.0f ns, %.1fx\n", layout_total, baseline_total,
+        baseline_total / layout_total);
+    CHECK(baseline_total >= MinSpeedup * layout_total);
+
+    return test_result("TextLayoutBenchmark");
+}
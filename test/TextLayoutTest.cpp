@@ -0,0 +1,379 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "TextLayout.h"
+#include "HeapCounter.h"
+#include "TestFonts.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Mytime::Windows;
+
+/**
+ * Width the way _lv_txt_get_width() works it out, straight from the font.
+ */
+static int32_t ref_width(const lv_font_t *font, lv_coord_t letter_space, const char *txt, uint32_t len)
+{
+    uint32_t i = 0;
+    int32_t width = 0;
+
+    while (i < len) {
+        uint32_t letter = _lv_txt_encoded_next(txt, &i);
+        uint32_t next = i;
+        uint32_t letter_next = (i < len) ? _lv_txt_encoded_next(txt, &next) : 0;
+        int32_t glyph = lv_font_get_glyph_width(font, letter, letter_next);
+        if (glyph > 0) {
+            width += glyph + letter_space;
+        }
+    }
+    return (width > 0) ? width - letter_space : 0;
+}
+
+static std::vector<std::string> words_of(const char *txt, uint32_t len)
+{
+    std::vector<std::string> words;
+    std::string word;
+
+    for (uint32_t i = 0; i <= len; i++) {
+        if (i == len || txt[i] == ' ' || txt[i] == '\0') {
+            if (!word.empty()) {
+                words.push_back(word);
+            }
+            word.clear();
+        } else {
+            word += txt[i];
+        }
+    }
+    return words;
+}
+
+/**
+ * Every line fits its chord, is as full as whole words allow, and the lines
+ * hold all the words in order.
+ */
+static void check_layout(const char *txt, uint32_t len, const lv_font_t *font, lv_coord_t letter_space,
+    int16_t radius)
+{
+    TextSpan span(txt, len);
+    const GlyphAdvance glyphs = GlyphAdvance::get(font, letter_space);
+    // What gets drawn, a NUL shows as a space
+    std::string drawn(txt, len);
+    std::replace(drawn.begin(), drawn.end(), '\0', ' ');
+
+    const ChordTable lines = ChordTable::get(radius, glyphs.line_height());
+    TextLayout layout;
+
+    std::vector<std::string> placed;
+    uint16_t start = 0;
+    bool more = true;
+
+    for (int screen = 0; more && screen < 200; screen++) {
+        uint8_t count = layout.layout(span, glyphs, lines, start);
+        CHECK(count <= lines.size());
+
+        for (uint8_t i = 0; i < count; i++) {
+            const LineRecord &line = layout[i];
+            const Lines &chord = lines.begin()[i];
+
+            CHECK(!line.ellipsis);
+            CHECK(line.offset + line.length <= len);
+            if (line.width > chord.max_length) {
+                // Only a single glyph wider than the line is let through
+                uint32_t glyph_end = 0;
+                _lv_txt_encoded_next(txt + line.offset, &glyph_end);
+                CHECK_EQ(line.length, glyph_end);
+            }
+            CHECK(line.length == 0 || line.width > 0);
+
+            std::vector<std::string> words = words_of(txt + line.offset, line.length);
+            bool cut = words.size() == 1 && line.offset + line.length < len &&
+                txt[line.offset + line.length] != ' ' && txt[line.offset + line.length] != '\0';
+
+            if (!cut) {
+                CHECK_EQ(line.width, ref_width(font, letter_space, drawn.c_str() + line.offset, line.length));
+            }
+
+            // The next word, with the spaces before it, would not have fitted
+            uint16_t end = line.offset + line.length;
+            uint16_t next_end = end;
+            while (next_end < len && (txt[next_end] == ' ' || txt[next_end] == '\0')) {
+                next_end++;
+            }
+            uint16_t next_start = next_end;
+            while (next_end < len && txt[next_end] != ' ' && txt[next_end] != '\0') {
+                next_end++;
+            }
+            if (line.length && !cut && next_end > next_start) {
+                CHECK(ref_width(font, letter_space, drawn.c_str() + line.offset, next_end - line.offset) > chord.max_length);
+            }
+
+            if (cut) {
+                placed.push_back(words[0] + "~");
+            } else {
+                placed.insert(placed.end(), words.begin(), words.end());
+            }
+        }
+
+        more = layout.more();
+        CHECK(!more || layout.consumed() > start || count == 0);
+        if (layout.consumed() == start) {
+            break;
+        }
+        start = layout.consumed();
+    }
+    CHECK(!more);
+
+    // Glue cut words back together before comparing
+    std::vector<std::string> joined;
+    bool carry = false;
+    for (const std::string &w : placed) {
+        bool cut = w.back() == '~';
+        std::string word = cut ? w.substr(0, w.size() - 1) : w;
+        if (carry) {
+            joined.back() += word;
+        } else {
+            joined.push_back(word);
+        }
+        carry = cut;
+    }
+    CHECK(joined == words_of(txt, len));
+}
+
+static void test_corpus()
+{
+    static const char * const texts[] = {
+        "OK",
+        "Running late, be there in 10 minutes. Can you order me a coffee?",
+        "To AVAVA Wa War. yay, AWAY Tea W W W T\xC3\xA9l\xC3\xA9phone",
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut "
+        "labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris "
+        "nisi ut aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit "
+        "esse cillum dolore eu fugiat nulla pariatur.",
+        "   leading and trailing   ",
+        "a    b     c",
+        "Internationalization is long",
+        "WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW",
+        "Caf\xC3\xA9 \xC3\xA0 16h, r\xC3\xA9union d\xC3\xA9plac\xC3\xA9" "e \xC3\xA0 la salle \xC3\xA9t\xC3\xA9",
+    };
+    static const lv_font_t * const fonts[] = {&test_font_kerned, &test_font_plain};
+    static const int16_t radii[] = {75, 100, 120};
+
+    for (const lv_font_t *font : fonts) {
+        for (lv_coord_t letter_space = 0; letter_space <= 2; letter_space += 2) {
+            for (int16_t r : radii) {
+                for (const char *txt : texts) {
+                    check_layout(txt, strlen(txt), font, letter_space, r);
+                }
+            }
+        }
+    }
+}
+
+static void test_wide_glyphs()
+{
+    // Advances over 255 px are not in the table and come from the font
+    const char *txt = "mow me now Wim aa";
+    check_layout(txt, strlen(txt), &test_font_wide, 0, 120);
+
+    const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_wide, 0);
+    CHECK_EQ(glyphs.advance('W', 0), 270);
+    CHECK_EQ(glyphs.advance('a', 'W'), 165);
+}
+
+static void test_tables_outlive_cache()
+{
+    // Held the way callers used to, then every cache slot loaded again
+    const GlyphAdvance &wide = GlyphAdvance::get(&test_font_wide, 0);
+    const lv_font_t *fonts[] = {&test_font_kerned, &test_font_plain, &test_font_large, &test_font_kerned};
+    for (uint8_t i = 0; i < 4; i++) {
+        GlyphAdvance::get(fonts[i], 11 + i);
+    }
+
+    CHECK_EQ(wide.advance('W', 0), 270);
+    CHECK_EQ(wide.letter_space(), 0);
+    CHECK_EQ(wide.line_height(), lv_font_get_line_height(&test_font_wide));
+    uint32_t first, last;
+    CHECK_EQ(wide.word("Wim", 3, first, last), ref_width(&test_font_wide, 0, "Wim", 3));
+}
+
+static void test_narrow_top_line()
+{
+    // Too wide for the first chord but not the circle, the first line stays empty
+    const char *txt = "Internationalization";
+    const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_kerned, 0);
+    const ChordTable lines = ChordTable::get(120, glyphs.line_height());
+    TextLayout layout;
+
+    int32_t width = ref_width(&test_font_kerned, 0, txt, strlen(txt));
+    CHECK(width > lines.begin()[0].max_length);
+    CHECK(width <= lines.widest());
+
+    layout.layout(TextSpan(txt), glyphs, lines);
+    CHECK_EQ(layout[0].length, 0);
+    CHECK_EQ(layout[0].width, 0);
+    CHECK_EQ(layout[1].length, strlen(txt));
+    CHECK_EQ(layout[1].width, width);
+    CHECK(!layout.more());
+    CHECK_EQ(layout.consumed(), strlen(txt));
+}
+
+static void test_cut_word_fills_lines()
+{
+    // Each piece of a word wider than the circle takes as much as its line holds
+    std::string txt(300, 'W');
+    const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_kerned, 1);
+    const ChordTable lines = ChordTable::get(100, glyphs.line_height());
+    TextLayout layout;
+
+    uint8_t count = layout.layout(TextSpan(txt.c_str()), glyphs, lines);
+    CHECK_EQ(count, lines.size());
+    for (uint8_t i = 0; i < count; i++) {
+        const LineRecord &line = layout[i];
+        CHECK(line.length > 0);
+        CHECK_EQ(line.width, ref_width(&test_font_kerned, 1, txt.c_str(), line.length));
+        CHECK(line.width <= lines.begin()[i].max_length);
+        CHECK(ref_width(&test_font_kerned, 1, txt.c_str(), line.length + 1) > lines.begin()[i].max_length);
+        if (i) {
+            CHECK_EQ(line.offset, layout[i - 1].offset + layout[i - 1].length);
+        }
+    }
+    CHECK(layout.more());
+}
+
+static void test_ellipsis()
+{
+    const char *txt =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut "
+        "labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris "
+        "nisi ut aliquip ex ea commodo consequat.";
+
+    for (lv_coord_t letter_space = 0; letter_space <= 3; letter_space += 3) {
+        const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_kerned, letter_space);
+        const ChordTable lines = ChordTable::get(75, glyphs.line_height());
+        TextLayout plain;
+        TextLayout dotted;
+
+        uint8_t count = plain.layout(TextSpan(txt), glyphs, lines);
+        CHECK(plain.more());
+        CHECK_EQ(dotted.layout(TextSpan(txt), glyphs, lines, 0, true), count);
+        CHECK(dotted.more());
+
+        // Only the last line changes, it gives up words to make room for "..."
+        for (uint8_t i = 0; i + 1 < count; i++) {
+            CHECK_EQ(dotted[i].offset, plain[i].offset);
+            CHECK_EQ(dotted[i].length, plain[i].length);
+            CHECK(!dotted[i].ellipsis);
+        }
+
+        const LineRecord &last = dotted[count - 1];
+        int32_t dots = ref_width(&test_font_kerned, letter_space, "...", 3);
+        CHECK(last.ellipsis);
+        CHECK_EQ(last.offset, plain[count - 1].offset);
+        CHECK(last.width <= lines.begin()[count - 1].max_length);
+        if (plain[count - 1].length) {
+            CHECK(last.length < plain[count - 1].length);
+        }
+        if (last.length) {
+            CHECK_EQ(last.width, ref_width(&test_font_kerned, letter_space, txt + last.offset, last.length) +
+                letter_space + dots);
+            CHECK_EQ(dotted.consumed(), last.offset + last.length);
+        } else {
+            // No word fitted next to the dots, they are drawn on their own
+            CHECK_EQ(last.width, dots);
+            CHECK_EQ(dotted.consumed(), dotted[count - 2].offset + dotted[count - 2].length);
+        }
+    }
+
+    // Text that fits gets no ellipsis
+    const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_kerned, 0);
+    const ChordTable lines = ChordTable::get(120, glyphs.line_height());
+    TextLayout layout;
+    uint8_t count = layout.layout(TextSpan("Short and sweet"), glyphs, lines, 0, true);
+    for (uint8_t i = 0; i < count; i++) {
+        CHECK(!layout[i].ellipsis);
+    }
+    CHECK(!layout.more());
+}
+
+static void test_nul_separates_words()
+{
+    static const char txt[] = "one\0two three\0\0four";
+    check_layout(txt, sizeof(txt) - 1, &test_font_kerned, 0, 120);
+
+    const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_kerned, 0);
+    const ChordTable lines = ChordTable::get(120, glyphs.line_height());
+    TextLayout layout;
+    layout.layout(TextSpan(txt, sizeof(txt) - 1), glyphs, lines);
+    CHECK_EQ(layout[0].offset, 0);
+    CHECK(layout[0].length > 3);
+    CHECK(!layout.more());
+
+    // A message buffer ends at its first NUL
+    std::array<char, 32> message = {};
+    memcpy(message.data(), "hello there", 11);
+    CHECK_EQ(TextSpan(message).len, 11);
+}
+
+static void test_no_heap()
+{
+    const char *txt =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut "
+        "labore et dolore magna aliqua. WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW T\xC3\xA9l\xC3\xA9phone";
+    TextSpan span(txt);
+
+    uint32_t allocs = heap_allocs();
+
+    // First use of a font and of a table included
+    const GlyphAdvance glyphs = GlyphAdvance::get(&test_font_wide, 0);
+    const ChordTable lines = ChordTable::get(90, glyphs.line_height());
+    const GlyphAdvance kerned = GlyphAdvance::get(&test_font_kerned, 4);
+    const ChordTable kerned_lines = ChordTable::get(110, kerned.line_height());
+    TextLayout layout;
+
+    for (uint16_t start = 0; start < span.len; start = layout.consumed()) {
+        layout.layout(span, kerned, kerned_lines, start, true);
+        layout.layout(span, kerned, kerned_lines, start);
+        if (!layout.more()) {
+            break;
+        }
+    }
+    layout.layout(span, glyphs, lines);
+
+    CHECK_EQ(heap_allocs(), allocs);
+}
+
+int main()
+{
+    // The counter must see an allocation, or it is not linked in
+    uint32_t allocs = heap_allocs();
+    std::string probe(100, 'x');
+    CHECK(heap_allocs() > allocs);
+
+    test_no_heap();
+    test_corpus();
+    test_wide_glyphs();
+    test_tables_outlive_cache();
+    test_narrow_top_line();
+    test_cut_word_fills_lines();
+    test_ellipsis();
+    test_nul_separates_words();
+
+    return test_result("TextLayoutTest");
+}
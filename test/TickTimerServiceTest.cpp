@@ -0,0 +1,333 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "TickTimerService.h"
+#include "TestCheck.h"
+
+#include <time.h>
+#include <vector>
+
+using namespace Mytime::Controllers;
+using namespace Mytime::Windows;
+
+events::EventQueue app_queue;
+
+// The wall clock runs off the kernel clock, a whole second of it ticks over
+// wherever set_clock() put the phase
+static int64_t wall_offset_ms = 0;
+
+static int64_t wall_ms()
+{
+    return (int64_t)host_kernel_ms + wall_offset_ms;
+}
+
+// Linked with --wrap=time, stands in for the RTC
+extern "C" time_t __wrap_time(time_t *t)
+{
+    time_t now = (time_t)(wall_ms() / 1000);
+    if (t) {
+        *t = now;
+    }
+    return now;
+}
+
+static time_t utc(int year, int mon, int mday, int hour, int min, int sec)
+{
+    struct tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = mon - 1;
+    tm.tm_mday = mday;
+    tm.tm_hour = hour;
+    tm.tm_min = min;
+    tm.tm_sec = sec;
+    return timegm(&tm);
+}
+
+// set_time() to now plus ms into the second
+static void set_clock(time_t now, uint32_t ms)
+{
+    wall_offset_ms = (int64_t)now * 1000 + ms - (int64_t)host_kernel_ms;
+}
+
+// Handlers run from the UI command queue in the render context
+static bool render_pending = false;
+
+static void render()
+{
+    render_pending = false;
+    UiCommandQueue::drain();
+}
+
+void RenderScheduler::kick()
+{
+    if (!render_pending) {
+        render_pending = true;
+        app_queue.call(&render);
+    }
+}
+
+struct Tick
+{
+    struct tm tm;
+    TimeUnits units;
+    int64_t error_ms;   // how long after the boundary it was delivered
+    uint32_t wakeups;   // service wakeups until then
+};
+
+struct Recorder
+{
+    std::vector<Tick> ticks;
+
+    void handler(struct tm *tm, TimeUnits units)
+    {
+        Tick tick;
+        tick.tm = *tm;
+        tick.units = units;
+        tick.error_ms = wall_ms() - (int64_t)timegm(tm) * 1000;
+        tick.wakeups = TickTimerService::wakeups();
+        ticks.push_back(tick);
+    };
+
+    TickTimerService::Handler callback() { return mbed::callback(this, &Recorder::handler); };
+};
+
+static const uint32_t Minute = MINUTE_UNIT | SECOND_UNIT;
+static const uint32_t Hour = HOUR_UNIT | Minute;
+static const uint32_t Day = DAY_UNIT | Hour;
+static const uint32_t Month = MONTH_UNIT | Day;
+static const uint32_t Year = YEAR_UNIT | Month;
+
+static void reset(time_t now, uint32_t ms)
+{
+    TickTimerService::unsubscribe_all();
+    app_queue.dispatch(0);
+    set_clock(now, ms);
+    // The phase of an earlier test is of no use here
+    TickTimerService::time_set();
+    app_queue.dispatch(0);
+}
+
+static void check_on_time(const std::vector<Tick> &ticks, size_t from = 0)
+{
+    for (size_t i = from; i < ticks.size(); i++) {
+        if (ticks[i].error_ms < 0 || ticks[i].error_ms > 10) {
+            CHECK_EQ(ticks[i].error_ms, 0);
+            printf("  tick %zu at %02d:%02d:%02d\n", i, ticks[i].tm.tm_hour, ticks[i].tm.tm_min, ticks[i].tm.tm_sec);
+        }
+    }
+}
+
+static void test_units_changed()
+{
+    struct tm from, to;
+    time_t t;
+
+    t = utc(2026, 10, 17, 12, 0, 59);
+    gmtime_r(&t, &from);
+    CHECK_EQ(TickTimerService::units_changed(from, from), 0u);
+    t++;
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), Minute);
+
+    t = utc(2026, 10, 17, 12, 0, 58);
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), (uint32_t)SECOND_UNIT);
+
+    t = utc(2026, 10, 17, 12, 59, 59);
+    gmtime_r(&t, &from);
+    t++;
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), Hour);
+
+    t = utc(2026, 10, 17, 23, 59, 59);
+    gmtime_r(&t, &from);
+    t++;
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), Day);
+
+    t = utc(2027, 2, 28, 23, 59, 59);
+    gmtime_r(&t, &from);
+    t++;
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), Month);
+    CHECK_EQ(to.tm_mon, 2);
+
+    t = utc(2026, 12, 31, 23, 59, 59);
+    gmtime_r(&t, &from);
+    t++;
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), Year);
+
+    // The same minute of another day still changes the day
+    t = utc(2026, 10, 17, 12, 30, 0);
+    gmtime_r(&t, &from);
+    t += 86400;
+    gmtime_r(&t, &to);
+    CHECK_EQ(TickTimerService::units_changed(from, to), Day);
+}
+
+/**
+ * A minute subscriber over three hours: every minute delivered within 10 ms
+ * of the boundary with the exact units, one wakeup a minute once the phase
+ * is known and a few more an hour to check it.
+ */
+static void test_minute_ticks()
+{
+    Recorder minutes;
+    reset(utc(2026, 10, 17, 9, 59, 17), 637);
+
+    TickTimerService::subscribe(MINUTE_UNIT, minutes.callback());
+    uint32_t start = TickTimerService::wakeups();
+    app_queue.dispatch(3 * 3600 * 1000);
+
+    CHECK_EQ(minutes.ticks.size(), 180u);
+    check_on_time(minutes.ticks);
+    for (size_t i = 0; i < minutes.ticks.size(); i++) {
+        const Tick &tick = minutes.ticks[i];
+        CHECK_EQ(tick.tm.tm_sec, 0);
+        CHECK_EQ(tick.tm.tm_min, (int)i % 60);
+        CHECK_EQ((uint32_t)tick.units, tick.tm.tm_min ? Minute : Hour);
+    }
+
+    // The first boundary polls for the phase, then one wakeup a minute
+    // until the hourly check aims a little early and polls again
+    CHECK(minutes.ticks[0].wakeups - start > 10);
+    uint32_t single = 0;
+    for (size_t i = 1; i < minutes.ticks.size(); i++) {
+        single += (minutes.ticks[i].wakeups - minutes.ticks[i - 1].wakeups == 1);
+    }
+    CHECK(single >= minutes.ticks.size() - 4);
+
+    uint32_t last_hour = TickTimerService::wakeups_last_hour();
+    printf("minute ticks: %u wakeups in 3 h, %u in the last hour\n", TickTimerService::wakeups() - start, last_hour);
+    CHECK(last_hour >= 60 && last_hour <= 70);
+}
+
+/**
+ * Day, month and year subscribers wake at midnight only, with every unit
+ * that changed.
+ */
+static void test_rollovers()
+{
+    Recorder minutes, days, years;
+    reset(utc(2026, 12, 31, 23, 58, 58), 120);
+
+    TickTimerService::subscribe(MINUTE_UNIT, minutes.callback());
+    TickTimerService::subscribe(DAY_UNIT, days.callback());
+    TickTimerService::subscribe(YEAR_UNIT, years.callback());
+    app_queue.dispatch(3 * 60 * 1000);
+
+    CHECK_EQ(minutes.ticks.size(), 3u);
+    CHECK_EQ(days.ticks.size(), 1u);
+    CHECK_EQ(years.ticks.size(), 1u);
+    if (minutes.ticks.size() == 3 && days.ticks.size() == 1 && years.ticks.size() == 1) {
+        CHECK_EQ((uint32_t)minutes.ticks[0].units, Minute);
+        CHECK_EQ((uint32_t)minutes.ticks[1].units, Year);
+        CHECK_EQ((uint32_t)minutes.ticks[2].units, Minute);
+        CHECK_EQ((uint32_t)days.ticks[0].units, Year);
+        CHECK_EQ(days.ticks[0].tm.tm_year, 127);
+        CHECK_EQ(days.ticks[0].tm.tm_yday, 0);
+        CHECK_EQ((uint32_t)years.ticks[0].units, Year);
+    }
+    check_on_time(minutes.ticks);
+    check_on_time(days.ticks);
+
+    // Into March, through a month of midnights
+    Recorder months;
+    days.ticks.clear();
+    reset(utc(2027, 2, 27, 23, 59, 50), 980);
+    TickTimerService::subscribe(DAY_UNIT, days.callback());
+    TickTimerService::subscribe(MONTH_UNIT, months.callback());
+    app_queue.dispatch(2 * 86400 * 1000);
+
+    CHECK_EQ(days.ticks.size(), 2u);
+    CHECK_EQ(months.ticks.size(), 1u);
+    if (days.ticks.size() == 2 && months.ticks.size() == 1) {
+        CHECK_EQ((uint32_t)days.ticks[0].units, Day);
+        CHECK_EQ(days.ticks[0].tm.tm_mday, 28);
+        CHECK_EQ((uint32_t)days.ticks[1].units, Month);
+        CHECK_EQ(days.ticks[1].tm.tm_mon, 2);
+        CHECK_EQ((uint32_t)months.ticks[0].units, Month);
+    }
+    check_on_time(days.ticks);
+}
+
+/**
+ * A clock set back or forward is shown at once and the ticks after it are
+ * on time again, as is one set back without time_set().
+ */
+static void test_clock_set()
+{
+    Recorder minutes;
+    reset(utc(2026, 10, 17, 12, 30, 20), 300);
+    TickTimerService::subscribe(MINUTE_UNIT, minutes.callback());
+    app_queue.dispatch(105 * 1000);
+    CHECK_EQ(minutes.ticks.size(), 2u);
+
+    // Back 22 minutes, 500 ms earlier in the second
+    set_clock(utc(2026, 10, 17, 12, 10, 40), 800);
+    TickTimerService::time_set();
+    app_queue.dispatch(0);
+    CHECK_EQ(minutes.ticks.size(), 3u);
+    CHECK_EQ(minutes.ticks.back().tm.tm_min, 10);
+    CHECK_EQ((uint32_t)minutes.ticks.back().units, Minute);
+
+    size_t from = minutes.ticks.size();
+    app_queue.dispatch(150 * 1000);
+    CHECK_EQ(minutes.ticks.size(), from + 3);
+    CHECK_EQ(minutes.ticks[from].tm.tm_min, 11);
+    check_on_time(minutes.ticks, from);
+
+    // Forward into the next day
+    set_clock(utc(2026, 10, 18, 7, 5, 10), 50);
+    TickTimerService::time_set();
+    app_queue.dispatch(0);
+    CHECK_EQ((uint32_t)minutes.ticks.back().units, Day);
+    from = minutes.ticks.size();
+    app_queue.dispatch(120 * 1000);
+    CHECK_EQ(minutes.ticks.size(), from + 2);
+    check_on_time(minutes.ticks, from);
+
+    // Set back behind the service's back, shown on its next wakeup
+    set_clock(utc(2026, 10, 18, 6, 0, 30), 400);
+    app_queue.dispatch(60 * 1000);
+    CHECK(minutes.ticks.size() >= from + 3);
+    size_t back = from + 2;
+    if (minutes.ticks.size() > back) {
+        CHECK_EQ(minutes.ticks[back].tm.tm_hour, 6);
+        CHECK_EQ((uint32_t)minutes.ticks[back].units, Hour);
+    }
+    from = minutes.ticks.size();
+    app_queue.dispatch(180 * 1000);
+    CHECK_EQ(minutes.ticks.size(), from + 3);
+    check_on_time(minutes.ticks, from);
+}
+
+int main()
+{
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    test_units_changed();
+    test_minute_ticks();
+    test_rollovers();
+    test_clock_set();
+
+    TickTimerService::unsubscribe_all();
+    app_queue.dispatch(0);
+    return test_result("TickTimerServiceTest");
+}
@@ -0,0 +1,202 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "UiCommandQueue.h"
+#include "RenderScheduler.h"
+#include "TestCheck.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Mytime::Controllers;
+
+static std::atomic<uint32_t> kicks(0);
+
+// The queue wakes the render context after every post
+void RenderScheduler::kick()
+{
+    kicks++;
+}
+
+static const int Producers = 4;
+static const uint32_t PerProducer = 20000;
+
+/**
+ * One posted command, checks it runs once and after the one posted before
+ * it by the same producer.
+ */
+struct Command
+{
+    int producer;
+    uint32_t n;
+
+    void run();
+};
+
+static uint32_t next_expected[Producers];
+static uint32_t ran = 0;
+static std::vector<Command> commands[Producers];
+
+void Command::run()
+{
+    CHECK_EQ(n, next_expected[producer]);
+    next_expected[producer] = n + 1;
+    ran++;
+}
+
+static void reset()
+{
+    while (UiCommandQueue::drain()) {
+    }
+    memset(next_expected, 0, sizeof(next_expected));
+    ran = 0;
+    for (int p = 0; p < Producers; p++) {
+        commands[p].clear();
+        for (uint32_t n = 0; n < PerProducer; n++) {
+            commands[p].push_back({p, n});
+        }
+    }
+}
+
+static bool post(int producer, uint32_t n)
+{
+    return UiCommandQueue::post(callback(&commands[producer][n], &Command::run));
+}
+
+static void test_in_order()
+{
+    reset();
+
+    uint32_t before = kicks;
+    for (uint32_t n = 0; n < 5; n++) {
+        CHECK(post(0, n));
+    }
+    CHECK_EQ(kicks, before + 5);
+    CHECK(!UiCommandQueue::empty());
+
+    CHECK_EQ(UiCommandQueue::drain(), 5);
+    CHECK_EQ(ran, 5);
+    CHECK(UiCommandQueue::empty());
+    CHECK_EQ(UiCommandQueue::drain(), 0);
+}
+
+static void test_full()
+{
+    reset();
+
+    uint32_t dropped = UiCommandQueue::dropped();
+    for (uint32_t n = 0; n < UiCommandQueue::Size; n++) {
+        CHECK(post(0, n));
+    }
+    CHECK(!post(0, UiCommandQueue::Size));
+    CHECK_EQ(UiCommandQueue::dropped(), dropped + 1);
+    CHECK_EQ(UiCommandQueue::high_water(), UiCommandQueue::Size);
+
+    CHECK_EQ(UiCommandQueue::drain(), UiCommandQueue::Size);
+    CHECK_EQ(ran, UiCommandQueue::Size);
+
+    // The dropped command can go in now
+    CHECK(post(1, 0));
+    CHECK_EQ(UiCommandQueue::drain(), 1);
+}
+
+static void test_wraparound()
+{
+    reset();
+
+    // Batches that never line up with the ring, over many turns
+    uint32_t n = 0;
+    for (uint32_t batch = 1; n + batch < PerProducer && n < 40 * UiCommandQueue::Size; batch = batch % 29 + 3) {
+        for (uint32_t i = 0; i < batch; i++) {
+            CHECK(post(0, n++));
+        }
+        CHECK_EQ(UiCommandQueue::drain(), batch);
+    }
+    CHECK_EQ(ran, n);
+    CHECK(UiCommandQueue::empty());
+}
+
+static void post_from_command()
+{
+    post(1, next_expected[1]);
+}
+
+static void test_posted_by_command()
+{
+    reset();
+
+    // Commands posted while draining wait for the next drain
+    CHECK(UiCommandQueue::post(post_from_command));
+    CHECK_EQ(UiCommandQueue::drain(), 1);
+    CHECK(!UiCommandQueue::empty());
+    CHECK_EQ(UiCommandQueue::drain(), 1);
+    CHECK_EQ(next_expected[1], 1);
+}
+
+static void test_many_producers()
+{
+    reset();
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> producers;
+    uint32_t posted = UiCommandQueue::posted();
+
+    for (int p = 0; p < Producers; p++) {
+        producers.emplace_back([p]() {
+            for (uint32_t n = 0; n < PerProducer; n++) {
+                // A full ring drops the command, post it again
+                while (!post(p, n)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Drains on its own thread, like the render context
+    std::thread consumer([&done]() {
+        while (!done || !UiCommandQueue::empty()) {
+            if (!UiCommandQueue::drain()) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (std::thread &t : producers) {
+        t.join();
+    }
+    done = true;
+    consumer.join();
+
+    CHECK_EQ(ran, Producers * PerProducer);
+    CHECK_EQ(UiCommandQueue::posted(), posted + Producers * PerProducer);
+    for (int p = 0; p < Producers; p++) {
+        CHECK_EQ(next_expected[p], PerProducer);
+    }
+    CHECK(UiCommandQueue::high_water() <= UiCommandQueue::Size);
+}
+
+int main()
+{
+    test_in_order();
+    test_full();
+    test_wraparound();
+    test_posted_by_command();
+    test_many_producers();
+
+    return test_result("UiCommandQueueTest");
+}
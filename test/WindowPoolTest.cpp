@@ -0,0 +1,132 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "WindowPool.h"
+#include "HeapCounter.h"
+#include "TestCheck.h"
+
+using namespace Mytime::Windows;
+
+// Root objects are only compared, any distinct addresses will do
+static char roots[8];
+
+static lv_obj_t *root(int i)
+{
+    return (lv_obj_t *)&roots[i];
+}
+
+static void on_load(Window *w)
+{
+}
+
+static void on_appear()
+{
+}
+
+static void test_fills_up()
+{
+    Window *windows[WindowPool::Size];
+
+    CHECK_EQ(WindowPool::in_use(), 0);
+    for (uint8_t i = 0; i < WindowPool::Size; i++) {
+        windows[i] = WindowPool::acquire(root(i));
+        CHECK(windows[i] != nullptr);
+        CHECK(windows[i]->getWindow() == root(i));
+        CHECK(!windows[i]->isLoaded());
+        for (uint8_t j = 0; j < i; j++) {
+            CHECK(windows[i] != windows[j]);
+        }
+        CHECK_EQ(WindowPool::in_use(), i + 1);
+    }
+
+    CHECK(WindowPool::acquire(root(7)) == nullptr);
+    CHECK_EQ(WindowPool::in_use(), WindowPool::Size);
+
+    for (uint8_t i = 0; i < WindowPool::Size; i++) {
+        WindowPool::release(windows[i]);
+    }
+    CHECK_EQ(WindowPool::in_use(), 0);
+}
+
+static void test_slot_reuse()
+{
+    Window *a = WindowPool::acquire(root(0));
+    Window *b = WindowPool::acquire(root(1));
+    Window *c = WindowPool::acquire(root(2));
+
+    WindowHandlers handlers;
+    handlers.load = on_load;
+    handlers.appear = on_appear;
+    b->setHandlers(handlers);
+    b->setLoaded(true);
+
+    // A released slot comes back clean, with nothing of the window before
+    WindowPool::release(b);
+    CHECK_EQ(WindowPool::in_use(), 2);
+
+    Window *d = WindowPool::acquire(root(3));
+    CHECK(d == b);
+    CHECK(d->getWindow() == root(3));
+    CHECK(!d->isLoaded());
+    CHECK(!d->getHandlers().load);
+    CHECK(!d->getHandlers().appear);
+    CHECK(!d->getHandlers().disappear);
+    CHECK(!d->getHandlers().unload);
+
+    // The others are left alone
+    CHECK(a->getWindow() == root(0));
+    CHECK(c->getWindow() == root(2));
+
+    // Releasing something the pool never handed out changes nothing
+    Window stray(root(5));
+    WindowPool::release(&stray);
+    WindowPool::release(nullptr);
+    CHECK_EQ(WindowPool::in_use(), 3);
+
+    WindowPool::release(a);
+    WindowPool::release(c);
+    WindowPool::release(d);
+    CHECK_EQ(WindowPool::in_use(), 0);
+}
+
+static void test_no_heap()
+{
+    uint32_t allocs = heap_allocs();
+
+    // Switching apps over and over
+    for (int i = 0; i < 1000; i++) {
+        Window *w = WindowPool::acquire(root(i % 8));
+        WindowHandlers handlers;
+        handlers.load = on_load;
+        w->setHandlers(handlers);
+        Window *popup = WindowPool::acquire(root((i + 1) % 8));
+        WindowPool::release(w);
+        WindowPool::release(popup);
+    }
+
+    CHECK_EQ(heap_allocs(), allocs);
+    CHECK_EQ(WindowPool::in_use(), 0);
+}
+
+int main()
+{
+    test_fills_up();
+    test_slot_reuse();
+    test_no_heap();
+
+    return test_result("WindowPoolTest");
+}
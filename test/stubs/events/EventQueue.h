@@ -0,0 +1,192 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_EVENT_QUEUE_H__
+#define __HOST_EVENT_QUEUE_H__
+
+#include "mbed.h"
+
+namespace events {
+    /**
+     * An EventQueue on the simulated kernel clock.
+     *
+     * Nothing runs until the test calls dispatch(), which moves
+     * host_kernel_ms on to each event as it comes due. Events due at the same
+     * time run in the order they were posted. Like a small mbed queue it
+     * holds Size events and a call fails with 0 when it is full, set_full()
+     * makes every call fail.
+     */
+    class EventQueue
+    {
+    public:
+        static constexpr int Size = 32;
+        // dispatch() gives up after this many events, a queue that never empties
+        static constexpr uint32_t MaxDispatch = 1000000;
+
+        EventQueue() : _events(), _next_id(1), _seq(0), _full(false), _dispatched(0) {};
+
+        template <typename F>
+        int call(F f) { return post(0, -1, mbed::Callback<void()>(f)); };
+
+        template <typename T, typename U>
+        int call(U *obj, void (T::*method)()) { return post(0, -1, mbed::Callback<void()>(obj, method)); };
+
+        template <typename F>
+        int call_in(int ms, F f) { return post(ms, -1, mbed::Callback<void()>(f)); };
+
+        template <typename T, typename U>
+        int call_in(int ms, U *obj, void (T::*method)()) { return post(ms, -1, mbed::Callback<void()>(obj, method)); };
+
+        template <typename F>
+        int call_every(int ms, F f) { return post(ms, ms, mbed::Callback<void()>(f)); };
+
+        template <typename T, typename U>
+        int call_every(int ms, U *obj, void (T::*method)()) { return post(ms, ms, mbed::Callback<void()>(obj, method)); };
+
+        bool cancel(int id)
+        {
+            Event *event = find(id);
+            if (event == nullptr) {
+                return false;
+            }
+            event->id = 0;
+            return true;
+        };
+
+        /**
+         * Milliseconds until the event runs, -1 if it is not queued.
+         */
+        int time_left(int id) const
+        {
+            for (const Event &event : _events) {
+                if (id != 0 && event.id == id) {
+                    return (event.due > host_kernel_ms) ? (int)(event.due - host_kernel_ms) : 0;
+                }
+            }
+            return -1;
+        };
+
+        /**
+         * Run the events due within ms and leave the clock ms on. With a
+         * negative ms run until the queue is empty.
+         */
+        void dispatch(int ms = -1)
+        {
+            uint64_t end = (ms < 0) ? UINT64_MAX : host_kernel_ms + ms;
+            uint32_t count = 0;
+
+            while (count < MaxDispatch) {
+                Event *next = nullptr;
+                for (Event &event : _events) {
+                    if (event.id && event.due <= end &&
+                        (next == nullptr || event.due < next->due || (event.due == next->due && event.seq < next->seq))) {
+                        next = &event;
+                    }
+                }
+                if (next == nullptr) {
+                    break;
+                }
+
+                host_kernel_ms = max_u64(host_kernel_ms, next->due);
+                mbed::Callback<void()> cb = next->cb;
+                if (next->period >= 0) {
+                    next->due += max_u64(next->period, 1);
+                    next->seq = _seq++;
+                } else {
+                    next->id = 0;
+                }
+                count++;
+                _dispatched++;
+                cb();
+            }
+
+            if (ms >= 0 && host_kernel_ms < end) {
+                host_kernel_ms = end;
+            }
+        };
+
+        void dispatch_forever() { dispatch(-1); };
+
+        void break_dispatch() {};
+
+        void set_full(bool full) { _full = full; };
+
+        /**
+         * Events run by dispatch() so far.
+         */
+        uint32_t dispatched() const { return _dispatched; };
+
+        int pending() const
+        {
+            int count = 0;
+            for (const Event &event : _events) {
+                count += event.id ? 1 : 0;
+            }
+            return count;
+        };
+
+    private:
+        struct Event
+        {
+            int id;
+            int period;
+            uint64_t due;
+            uint32_t seq;
+            mbed::Callback<void()> cb;
+        };
+
+        static uint64_t max_u64(uint64_t a, uint64_t b) { return (a > b) ? a : b; };
+
+        Event* find(int id)
+        {
+            for (Event &event : _events) {
+                if (id != 0 && event.id == id) {
+                    return &event;
+                }
+            }
+            return nullptr;
+        };
+
+        int post(int ms, int period, const mbed::Callback<void()> &cb)
+        {
+            if (_full) {
+                return 0;
+            }
+            for (Event &event : _events) {
+                if (event.id == 0) {
+                    event.id = _next_id++;
+                    if (_next_id <= 0) {
+                        _next_id = 1;
+                    }
+                    event.period = period;
+                    event.due = host_kernel_ms + ((ms > 0) ? ms : 0);
+                    event.seq = _seq++;
+                    event.cb = cb;
+                    return event.id;
+                }
+            }
+            return 0;
+        };
+
+        Event _events[Size];
+        int _next_id;
+        uint32_t _seq;
+        bool _full;
+        uint32_t _dispatched;
+    };
+}
+
+#endif /* __HOST_EVENT_QUEUE_H__ */
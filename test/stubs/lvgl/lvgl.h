@@ -0,0 +1,257 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_LVGL_H__
+#define __HOST_LVGL_H__
+
+// The LVGL v7 types and calls the pure logic under src/ uses, for host builds.
+// Layouts follow lvgl v7 where the code reads fields, the rest is left out.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LV_HOR_RES_MAX          (240)
+#define LV_VER_RES_MAX          (240)
+#define LV_COLOR_DEPTH          16
+#define LV_COLOR_16_SWAP        1
+#define LV_INV_BUF_SIZE         32
+#define LV_DISP_DEF_REFR_PERIOD 30
+
+#define LV_MATH_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define LV_MATH_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define LV_MATH_ABS(x) ((x) > 0 ? (x) : (-(x)))
+
+typedef int16_t lv_coord_t;
+#define LV_COORD_MAX ((lv_coord_t)((uint32_t)((uint32_t)1 << (8 * sizeof(lv_coord_t) - 1)) - 1000))
+
+typedef struct
+{
+    lv_coord_t x1;
+    lv_coord_t y1;
+    lv_coord_t x2;
+    lv_coord_t y2;
+} lv_area_t;
+
+static inline void lv_area_set(lv_area_t *area_p, lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    area_p->x1 = x1;
+    area_p->y1 = y1;
+    area_p->x2 = x2;
+    area_p->y2 = y2;
+}
+
+static inline void lv_area_copy(lv_area_t *dest, const lv_area_t *src)
+{
+    memcpy(dest, src, sizeof(lv_area_t));
+}
+
+static inline lv_coord_t lv_area_get_width(const lv_area_t *area_p)
+{
+    return (lv_coord_t)(area_p->x2 - area_p->x1 + 1);
+}
+
+static inline lv_coord_t lv_area_get_height(const lv_area_t *area_p)
+{
+    return (lv_coord_t)(area_p->y2 - area_p->y1 + 1);
+}
+
+static inline uint32_t lv_area_get_size(const lv_area_t *area_p)
+{
+    return (uint32_t)(area_p->x2 - area_p->x1 + 1) * (area_p->y2 - area_p->y1 + 1);
+}
+
+static inline void _lv_area_join(lv_area_t *a_res_p, const lv_area_t *a1_p, const lv_area_t *a2_p)
+{
+    a_res_p->x1 = LV_MATH_MIN(a1_p->x1, a2_p->x1);
+    a_res_p->y1 = LV_MATH_MIN(a1_p->y1, a2_p->y1);
+    a_res_p->x2 = LV_MATH_MAX(a1_p->x2, a2_p->x2);
+    a_res_p->y2 = LV_MATH_MAX(a1_p->y2, a2_p->y2);
+}
+
+static inline bool _lv_area_intersect(lv_area_t *res_p, const lv_area_t *a1_p, const lv_area_t *a2_p)
+{
+    res_p->x1 = LV_MATH_MAX(a1_p->x1, a2_p->x1);
+    res_p->y1 = LV_MATH_MAX(a1_p->y1, a2_p->y1);
+    res_p->x2 = LV_MATH_MIN(a1_p->x2, a2_p->x2);
+    res_p->y2 = LV_MATH_MIN(a1_p->y2, a2_p->y2);
+    return res_p->x1 <= res_p->x2 && res_p->y1 <= res_p->y2;
+}
+
+typedef union
+{
+    struct
+    {
+        uint16_t green_h : 3;
+        uint16_t red : 5;
+        uint16_t blue : 5;
+        uint16_t green_l : 3;
+    } ch;
+    uint16_t full;
+} lv_color_t;
+
+// lvgl's linked list, a fixed array of node pointers here
+#define HOST_LL_MAX 8
+
+typedef struct
+{
+    void *nodes[HOST_LL_MAX];
+    uint8_t count;
+} lv_ll_t;
+
+void *_lv_ll_get_head(const lv_ll_t *ll_p);
+void *_lv_ll_get_next(const lv_ll_t *ll_p, const void *n_act);
+
+enum {
+    LV_TASK_PRIO_OFF = 0,
+    LV_TASK_PRIO_LOWEST,
+    LV_TASK_PRIO_LOW,
+    LV_TASK_PRIO_MID,
+    LV_TASK_PRIO_HIGH,
+    LV_TASK_PRIO_HIGHEST,
+};
+typedef uint8_t lv_task_prio_t;
+
+typedef struct _lv_task_t lv_task_t;
+typedef void (*lv_task_cb_t)(lv_task_t *);
+
+struct _lv_task_t
+{
+    uint32_t period;
+    uint32_t last_run;
+    lv_task_cb_t task_cb;
+    void *user_data;
+    uint8_t prio : 3;
+};
+
+void lv_task_set_cb(lv_task_t *task, lv_task_cb_t task_cb);
+
+// Tasks on the simulated clock, run in order of priority like lv_task.c
+lv_task_t *lv_task_create(lv_task_cb_t task_xcb, uint32_t period, lv_task_prio_t prio, void *user_data);
+void lv_task_set_prio(lv_task_t *task, lv_task_prio_t prio);
+uint32_t lv_task_handler(void);
+
+typedef struct
+{
+    void *buf1;
+    void *buf2;
+    void *buf_act;
+    uint32_t size;
+    lv_area_t area;
+    volatile int flushing;
+    volatile int flushing_last;
+    uint8_t last_area;
+    uint8_t last_part;
+} lv_disp_buf_t;
+
+typedef struct _disp_drv_t
+{
+    lv_coord_t hor_res;
+    lv_coord_t ver_res;
+    lv_disp_buf_t *buffer;
+    void (*flush_cb)(struct _disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
+    void (*rounder_cb)(struct _disp_drv_t *disp_drv, lv_area_t *area);
+    void (*wait_cb)(struct _disp_drv_t *disp_drv);
+    void (*gpu_fill_cb)(struct _disp_drv_t *disp_drv, lv_color_t *dest_buf, lv_coord_t dest_width,
+        const lv_area_t *fill_area, lv_color_t color);
+    void *user_data;
+} lv_disp_drv_t;
+
+void lv_disp_flush_ready(lv_disp_drv_t *disp_drv);
+
+typedef struct _disp_t
+{
+    lv_disp_drv_t driver;
+    lv_task_t *refr_task;
+    lv_area_t inv_areas[LV_INV_BUF_SIZE];
+    uint8_t inv_area_joined[LV_INV_BUF_SIZE];
+    uint32_t inv_p;
+} lv_disp_t;
+
+void _lv_disp_refr_task(lv_task_t *task);
+
+// The simulated kernel clock, see host_kernel_ms in mbed.h
+uint32_t lv_tick_get(void);
+uint32_t lv_tick_elaps(uint32_t prev_tick);
+
+// One display, refreshed like lvgl v7's lv_refr.c, see support/HostLvgl.h
+void lv_disp_drv_init(lv_disp_drv_t *driver);
+void lv_disp_buf_init(lv_disp_buf_t *disp_buf, void *buf1, void *buf2, uint32_t size_in_px_cnt);
+lv_disp_t *lv_disp_drv_register(lv_disp_drv_t *driver);
+lv_disp_t *lv_disp_get_default(void);
+void _lv_inv_area(lv_disp_t *disp, const lv_area_t *area_p);
+void lv_refr_now(lv_disp_t *disp);
+
+// Only ever handled by pointer in the code under test
+typedef struct _lv_obj_t lv_obj_t;
+
+// The one screen, invalidating it invalidates the whole display
+lv_obj_t *lv_scr_act(void);
+void lv_obj_invalidate(const lv_obj_t *obj);
+
+typedef struct
+{
+    uint16_t adv_w;
+    uint16_t box_w;
+    uint16_t box_h;
+    int16_t ofs_x;
+    int16_t ofs_y;
+    uint8_t bpp;
+} lv_font_glyph_dsc_t;
+
+typedef struct _lv_font_struct
+{
+    bool (*get_glyph_dsc)(const struct _lv_font_struct *, lv_font_glyph_dsc_t *, uint32_t letter, uint32_t letter_next);
+    const uint8_t *(*get_glyph_bitmap)(const struct _lv_font_struct *, uint32_t);
+    lv_coord_t line_height;
+    lv_coord_t base_line;
+    uint8_t subpx;
+    int8_t underline_position;
+    int8_t underline_thickness;
+    void *dsc;
+    void *user_data;
+} lv_font_t;
+
+/**
+ * Descriptor of the built in font format. Only kern_dsc is read by the code
+ * under test, the host fonts keep their advances and kerning in the rest.
+ */
+typedef struct
+{
+    const void *kern_dsc;
+    uint16_t kern_scale;
+    const uint16_t *adv_w;          // printable ASCII advances, 1/16 px
+    uint16_t adv_w_other;           // everything else, 1/16 px
+    const char *kern_pairs;         // two letters per pair
+    const int8_t *kern_values;      // 1/16 px before kern_scale
+    uint16_t kern_count;
+} lv_font_fmt_txt_dsc_t;
+
+bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+    uint32_t letter_next);
+bool lv_font_get_glyph_dsc(const lv_font_t *font_p, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+    uint32_t letter_next);
+uint16_t lv_font_get_glyph_width(const lv_font_t *font, uint32_t letter, uint32_t letter_next);
+
+static inline lv_coord_t lv_font_get_line_height(const lv_font_t *font_p)
+{
+    return font_p->line_height;
+}
+
+// UTF-8 decoder, a function pointer in lvgl v7 as well
+extern uint32_t (*_lv_txt_encoded_next)(const char *, uint32_t *);
+
+#endif /* __HOST_LVGL_H__ */
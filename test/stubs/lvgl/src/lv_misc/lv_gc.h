@@ -0,0 +1,28 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_LV_GC_H__
+#define __HOST_LV_GC_H__
+
+// lvgl's roots without LV_ENABLE_GC, only the task list is used
+
+#include <lvgl/lvgl.h>
+
+#define LV_GC_ROOT(x) x
+
+extern lv_ll_t _lv_task_ll;
+
+#endif /* __HOST_LV_GC_H__ */
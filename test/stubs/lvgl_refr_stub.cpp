@@ -0,0 +1,467 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "HostLvgl.h"
+
+#include <lvgl/src/lv_misc/lv_gc.h>
+
+#include <chrono>
+
+// Below this many pixels lvgl v7 fills in software even with a gpu_fill_cb
+#define GPU_SIZE_LIMIT 240
+
+uint32_t host_refr_runs = 0;
+
+lv_ll_t _lv_task_ll;
+
+static lv_disp_t disp;
+static lv_task_t refr_task;
+static lv_task_t tasks[HOST_LL_MAX];
+static uint8_t task_count = 0;
+static bool registered = false;
+static HostRefrStats stats;
+static const HostLayer *layers = NULL;
+static uint8_t layer_count = 0;
+// Stands in for the active screen, only its address is used
+static char screen;
+
+static lv_color_t swapped(uint16_t c)
+{
+    lv_color_t color;
+    color.full = (uint16_t)((c >> 8) | (c << 8));
+    return color;
+}
+
+void host_lvgl_reset()
+{
+    memset(&disp, 0, sizeof(disp));
+    memset(&refr_task, 0, sizeof(refr_task));
+    memset(&_lv_task_ll, 0, sizeof(_lv_task_ll));
+    memset(tasks, 0, sizeof(tasks));
+    task_count = 0;
+    memset(&stats, 0, sizeof(stats));
+    registered = false;
+    layers = NULL;
+    layer_count = 0;
+}
+
+void host_screen_set(const HostLayer *screen_layers, uint8_t count)
+{
+    layers = screen_layers;
+    layer_count = count;
+}
+
+const HostRefrStats& host_refr_stats()
+{
+    return stats;
+}
+
+uint32_t lv_tick_get(void)
+{
+    return (uint32_t)host_kernel_ms;
+}
+
+uint32_t lv_tick_elaps(uint32_t prev_tick)
+{
+    return lv_tick_get() - prev_tick;
+}
+
+void *_lv_ll_get_head(const lv_ll_t *ll_p)
+{
+    return ll_p->count ? ll_p->nodes[0] : NULL;
+}
+
+void *_lv_ll_get_next(const lv_ll_t *ll_p, const void *n_act)
+{
+    for (uint8_t i = 0; i + 1 < ll_p->count; i++) {
+        if (ll_p->nodes[i] == n_act) {
+            return ll_p->nodes[i + 1];
+        }
+    }
+    return NULL;
+}
+
+// Higher priorities first, a new task after those of its own priority
+static void task_insert(lv_task_t *task)
+{
+    if (_lv_task_ll.count >= HOST_LL_MAX) {
+        printf("lvgl stub: task list full\n");
+        abort();
+    }
+
+    uint8_t i = 0;
+    while (i < _lv_task_ll.count && ((lv_task_t *)_lv_task_ll.nodes[i])->prio >= task->prio) {
+        i++;
+    }
+    memmove(&_lv_task_ll.nodes[i + 1], &_lv_task_ll.nodes[i], (_lv_task_ll.count - i) * sizeof(void *));
+    _lv_task_ll.nodes[i] = task;
+    _lv_task_ll.count++;
+}
+
+lv_task_t *lv_task_create(lv_task_cb_t task_xcb, uint32_t period, lv_task_prio_t prio, void *user_data)
+{
+    if (task_count >= HOST_LL_MAX) {
+        printf("lvgl stub: too many tasks\n");
+        abort();
+    }
+
+    lv_task_t *task = &tasks[task_count++];
+    memset(task, 0, sizeof(*task));
+    task->period = period;
+    task->last_run = lv_tick_get();
+    task->task_cb = task_xcb;
+    task->user_data = user_data;
+    task->prio = prio;
+    task_insert(task);
+    return task;
+}
+
+void lv_task_set_prio(lv_task_t *task, lv_task_prio_t prio)
+{
+    task->prio = prio;
+}
+
+uint32_t lv_task_handler(void)
+{
+    uint32_t time_till_next = UINT32_MAX;
+
+    for (uint8_t i = 0; i < _lv_task_ll.count; i++) {
+        lv_task_t *task = (lv_task_t *)_lv_task_ll.nodes[i];
+        if (task->prio == LV_TASK_PRIO_OFF) {
+            continue;
+        }
+
+        if (lv_tick_elaps(task->last_run) >= task->period) {
+            task->last_run = lv_tick_get();
+            if (task->task_cb) {
+                task->task_cb(task);
+            }
+        }
+
+        if (task->prio != LV_TASK_PRIO_OFF) {
+            uint32_t elapsed = lv_tick_elaps(task->last_run);
+            uint32_t remaining = (elapsed >= task->period) ? 0 : task->period - elapsed;
+            time_till_next = LV_MATH_MIN(time_till_next, remaining);
+        }
+    }
+
+    return time_till_next;
+}
+
+void lv_disp_drv_init(lv_disp_drv_t *driver)
+{
+    memset(driver, 0, sizeof(*driver));
+    driver->hor_res = LV_HOR_RES_MAX;
+    driver->ver_res = LV_VER_RES_MAX;
+}
+
+void lv_disp_buf_init(lv_disp_buf_t *disp_buf, void *buf1, void *buf2, uint32_t size_in_px_cnt)
+{
+    memset(disp_buf, 0, sizeof(*disp_buf));
+    disp_buf->buf1 = buf1;
+    disp_buf->buf2 = buf2;
+    disp_buf->buf_act = buf1;
+    disp_buf->size = size_in_px_cnt;
+}
+
+lv_disp_t *lv_disp_drv_register(lv_disp_drv_t *driver)
+{
+    memset(&disp, 0, sizeof(disp));
+    disp.driver = *driver;
+
+    memset(&refr_task, 0, sizeof(refr_task));
+    refr_task.period = LV_DISP_DEF_REFR_PERIOD;
+    refr_task.last_run = lv_tick_get();
+    refr_task.task_cb = _lv_disp_refr_task;
+    refr_task.user_data = &disp;
+    refr_task.prio = LV_TASK_PRIO_MID;
+    disp.refr_task = &refr_task;
+    if (!registered) {
+        task_insert(&refr_task);
+    }
+    registered = true;
+
+    // A new display starts with its screen to draw
+    lv_obj_invalidate(lv_scr_act());
+    return &disp;
+}
+
+lv_disp_t *lv_disp_get_default(void)
+{
+    return registered ? &disp : NULL;
+}
+
+lv_obj_t *lv_scr_act(void)
+{
+    return (lv_obj_t *)&screen;
+}
+
+void lv_obj_invalidate(const lv_obj_t *obj)
+{
+    lv_area_t area;
+    lv_area_set(&area, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    _lv_inv_area(lv_disp_get_default(), &area);
+}
+
+static bool area_is_in(const lv_area_t *in, const lv_area_t *holder)
+{
+    return in->x1 >= holder->x1 && in->y1 >= holder->y1 && in->x2 <= holder->x2 && in->y2 <= holder->y2;
+}
+
+static bool area_is_on(const lv_area_t *a1, const lv_area_t *a2)
+{
+    return a1->x1 <= a2->x2 && a1->x2 >= a2->x1 && a1->y1 <= a2->y2 && a1->y2 >= a2->y1;
+}
+
+void _lv_inv_area(lv_disp_t *d, const lv_area_t *area_p)
+{
+    if (d == NULL) {
+        return;
+    }
+    if (area_p == NULL) {
+        d->inv_p = 0;
+        return;
+    }
+
+    lv_area_t scr_area;
+    lv_area_set(&scr_area, 0, 0, d->driver.hor_res - 1, d->driver.ver_res - 1);
+    lv_area_t com_area;
+    if (!_lv_area_intersect(&com_area, area_p, &scr_area)) {
+        return;
+    }
+
+    if (d->driver.rounder_cb) {
+        d->driver.rounder_cb(&d->driver, &com_area);
+    }
+
+    for (uint32_t i = 0; i < d->inv_p; i++) {
+        if (area_is_in(&com_area, &d->inv_areas[i])) {
+            return;
+        }
+    }
+
+    if (d->inv_p < LV_INV_BUF_SIZE) {
+        lv_area_copy(&d->inv_areas[d->inv_p], &com_area);
+    } else {
+        // No room left, redraw everything
+        d->inv_p = 0;
+        lv_area_copy(&d->inv_areas[d->inv_p], &scr_area);
+    }
+    d->inv_p++;
+}
+
+// lv_refr_join_area()
+static void join_areas(lv_disp_t *d)
+{
+    for (uint32_t join_in = 0; join_in < d->inv_p; join_in++) {
+        if (d->inv_area_joined[join_in]) {
+            continue;
+        }
+        for (uint32_t join_from = 0; join_from < d->inv_p; join_from++) {
+            if (d->inv_area_joined[join_from] || join_in == join_from ||
+                !area_is_on(&d->inv_areas[join_in], &d->inv_areas[join_from])) {
+                continue;
+            }
+
+            lv_area_t joined;
+            _lv_area_join(&joined, &d->inv_areas[join_in], &d->inv_areas[join_from]);
+            if (lv_area_get_size(&joined) <
+                lv_area_get_size(&d->inv_areas[join_in]) + lv_area_get_size(&d->inv_areas[join_from])) {
+                lv_area_copy(&d->inv_areas[join_in], &joined);
+                d->inv_area_joined[join_from] = 1;
+            }
+        }
+    }
+}
+
+static void wait_flushed(lv_disp_t *d)
+{
+    lv_disp_buf_t *vdb = d->driver.buffer;
+    while (vdb->flushing) {
+        if (d->driver.wait_cb) {
+            d->driver.wait_cb(&d->driver);
+        }
+    }
+}
+
+static void fill_solid(lv_disp_t *d, lv_color_t *buf, const lv_area_t &buf_area, const lv_area_t &draw,
+    lv_color_t color)
+{
+    lv_coord_t w = lv_area_get_width(&buf_area);
+    // Relative to the draw buffer, like _lv_blend_fill() passes it
+    lv_area_t rel;
+    lv_area_set(&rel, draw.x1 - buf_area.x1, draw.y1 - buf_area.y1, draw.x2 - buf_area.x1, draw.y2 - buf_area.y1);
+    auto start = std::chrono::steady_clock::now();
+
+    if (d->driver.gpu_fill_cb && lv_area_get_size(&rel) > GPU_SIZE_LIMIT) {
+        d->driver.gpu_fill_cb(&d->driver, buf, w, &rel, color);
+        stats.gpu_px += lv_area_get_size(&rel);
+    } else {
+        for (lv_coord_t y = rel.y1; y <= rel.y2; y++) {
+            lv_color_t *dest = buf + (int32_t)y * w;
+            for (lv_coord_t x = rel.x1; x <= rel.x2; x++) {
+                dest[x] = color;
+            }
+        }
+        stats.software_px += lv_area_get_size(&rel);
+    }
+
+    stats.fill_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// lv_refr_area_part() and lv_refr_vdb_flush()
+static void refr_area_part(lv_disp_t *d, const lv_area_t *area_p)
+{
+    lv_disp_buf_t *vdb = d->driver.buffer;
+    bool double_buf = vdb->buf1 && vdb->buf2;
+
+    if (!double_buf) {
+        wait_flushed(d);
+    }
+
+    lv_area_t mask;
+    _lv_area_intersect(&mask, area_p, &vdb->area);
+    lv_color_t *buf = (lv_color_t *)vdb->buf_act;
+    lv_coord_t w = lv_area_get_width(&vdb->area);
+
+    for (uint8_t l = 0; l < layer_count; l++) {
+        lv_area_t draw;
+        if (!_lv_area_intersect(&draw, &layers[l].area, &mask)) {
+            continue;
+        }
+        if (layers[l].pattern) {
+            for (lv_coord_t y = draw.y1; y <= draw.y2; y++) {
+                for (lv_coord_t x = draw.x1; x <= draw.x2; x++) {
+                    buf[(int32_t)(y - vdb->area.y1) * w + (x - vdb->area.x1)] = swapped(layers[l].pattern(x, y));
+                }
+            }
+            stats.pattern_px += lv_area_get_size(&draw);
+        } else {
+            fill_solid(d, buf, vdb->area, draw, swapped(layers[l].color));
+        }
+    }
+
+    if (double_buf) {
+        wait_flushed(d);
+    }
+    vdb->flushing = 1;
+    vdb->flushing_last = vdb->last_area && vdb->last_part;
+    stats.strips++;
+    stats.max_rows = LV_MATH_MAX(stats.max_rows, lv_area_get_height(&vdb->area));
+    if (d->driver.flush_cb) {
+        d->driver.flush_cb(&d->driver, &vdb->area, buf);
+    }
+    if (double_buf) {
+        vdb->buf_act = (vdb->buf_act == vdb->buf1) ? vdb->buf2 : vdb->buf1;
+    }
+}
+
+// lv_refr_area(), strips as high as the buffer and the rounder allow
+static void refr_area(lv_disp_t *d, const lv_area_t *area_p)
+{
+    lv_disp_buf_t *vdb = d->driver.buffer;
+    lv_coord_t w = lv_area_get_width(area_p);
+    lv_coord_t h = lv_area_get_height(area_p);
+    lv_coord_t y2 = (area_p->y2 >= d->driver.ver_res) ? d->driver.ver_res - 1 : area_p->y2;
+
+    int32_t max_row = (int32_t)(vdb->size / w);
+    if (max_row > h) {
+        max_row = h;
+    }
+
+    if (d->driver.rounder_cb) {
+        lv_area_t tmp;
+        tmp.x1 = 0;
+        tmp.x2 = 0;
+        tmp.y1 = 0;
+        lv_coord_t h_tmp = max_row;
+        do {
+            tmp.y2 = h_tmp - 1;
+            d->driver.rounder_cb(&d->driver, &tmp);
+            if (lv_area_get_height(&tmp) <= max_row) {
+                break;
+            }
+            h_tmp--;
+        } while (h_tmp > 0);
+
+        if (h_tmp <= 0) {
+            return;
+        }
+        max_row = tmp.y2 + 1;
+    }
+
+    lv_coord_t row;
+    lv_coord_t row_last = 0;
+    for (row = area_p->y1; row + max_row - 1 <= y2; row += max_row) {
+        lv_area_set(&vdb->area, area_p->x1, row, area_p->x2, LV_MATH_MIN(row + max_row - 1, y2));
+        row_last = vdb->area.y2;
+        vdb->last_part = (y2 == row_last);
+        refr_area_part(d, area_p);
+    }
+    if (y2 != row_last) {
+        lv_area_set(&vdb->area, area_p->x1, row, area_p->x2, y2);
+        vdb->last_part = 1;
+        refr_area_part(d, area_p);
+    }
+}
+
+void _lv_disp_refr_task(lv_task_t *task)
+{
+    host_refr_runs++;
+
+    lv_disp_t *d = task ? (lv_disp_t *)task->user_data : lv_disp_get_default();
+    if (task) {
+        task->last_run = lv_tick_get();
+    }
+    if (d == NULL || d->driver.buffer == NULL || d->inv_p == 0) {
+        return;
+    }
+
+    join_areas(d);
+
+    int32_t last = -1;
+    for (uint32_t i = 0; i < d->inv_p; i++) {
+        if (!d->inv_area_joined[i]) {
+            last = i;
+        }
+    }
+
+    stats.refreshes++;
+    for (uint32_t i = 0; i < d->inv_p; i++) {
+        if (d->inv_area_joined[i]) {
+            continue;
+        }
+        d->driver.buffer->last_area = ((int32_t)i == last);
+        d->driver.buffer->last_part = 0;
+        stats.areas++;
+        refr_area(d, &d->inv_areas[i]);
+    }
+
+    memset(d->inv_area_joined, 0, sizeof(d->inv_area_joined));
+    d->inv_p = 0;
+}
+
+void lv_refr_now(lv_disp_t *d)
+{
+    if (d == NULL) {
+        d = lv_disp_get_default();
+    }
+    if (d) {
+        _lv_disp_refr_task(d->refr_task);
+    }
+}
@@ -0,0 +1,114 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <lvgl/lvgl.h>
+
+// Counts for the tests, not part of lvgl
+uint32_t host_glyph_lookups = 0;
+uint32_t host_flush_ready = 0;
+
+void lv_task_set_cb(lv_task_t *task, lv_task_cb_t task_cb)
+{
+    task->task_cb = task_cb;
+}
+
+void lv_disp_flush_ready(lv_disp_drv_t *disp_drv)
+{
+    host_flush_ready++;
+    disp_drv->buffer->flushing = 0;
+    disp_drv->buffer->flushing_last = 0;
+}
+
+bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+    uint32_t letter_next)
+{
+    const lv_font_fmt_txt_dsc_t *fdsc = (const lv_font_fmt_txt_dsc_t *)font->dsc;
+    bool is_tab = false;
+
+    host_glyph_lookups++;
+    if (letter == '\t') {
+        letter = ' ';
+        is_tab = true;
+    }
+    if (letter < 0x20 || letter == 0x7F) {
+        return false;
+    }
+
+    uint32_t adv_w = (letter < 0x7F) ? fdsc->adv_w[letter - 0x20] : fdsc->adv_w_other;
+    if (is_tab) {
+        adv_w *= 2;
+    }
+
+    if (fdsc->kern_dsc && letter_next) {
+        for (uint16_t i = 0; i < fdsc->kern_count; i++) {
+            if ((uint8_t)fdsc->kern_pairs[2 * i] == letter && (uint8_t)fdsc->kern_pairs[2 * i + 1] == letter_next) {
+                adv_w += ((int32_t)fdsc->kern_values[i] * fdsc->kern_scale) >> 4;
+                break;
+            }
+        }
+    }
+
+    // Same 12.4 fixed point rounding as lvgl
+    memset(dsc_out, 0, sizeof(*dsc_out));
+    dsc_out->adv_w = (adv_w + (1 << 3)) >> 4;
+    dsc_out->box_w = dsc_out->adv_w;
+    dsc_out->box_h = font->line_height;
+    dsc_out->bpp = 4;
+    return true;
+}
+
+bool lv_font_get_glyph_dsc(const lv_font_t *font_p, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+    uint32_t letter_next)
+{
+    return font_p->get_glyph_dsc(font_p, dsc_out, letter, letter_next);
+}
+
+uint16_t lv_font_get_glyph_width(const lv_font_t *font, uint32_t letter, uint32_t letter_next)
+{
+    lv_font_glyph_dsc_t g;
+    return lv_font_get_glyph_dsc(font, &g, letter, letter_next) ? g.adv_w : 0;
+}
+
+static uint32_t utf8_next(const char *txt, uint32_t *i)
+{
+    const uint8_t *s = (const uint8_t *)txt;
+    uint32_t c = s[*i];
+
+    if (c < 0x80) {
+        (*i)++;
+        return c;
+    }
+
+    uint32_t extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+    if (extra == 0) {
+        // Stray continuation byte, step over it like lvgl does
+        (*i)++;
+        return 0;
+    }
+
+    c &= 0x3F >> extra;
+    (*i)++;
+    for (uint32_t k = 0; k < extra; k++) {
+        if ((s[*i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        c = (c << 6) | (s[*i] & 0x3F);
+        (*i)++;
+    }
+    return c;
+}
+
+uint32_t (*_lv_txt_encoded_next)(const char *, uint32_t *) = utf8_next;
@@ -0,0 +1,269 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_MBED_H__
+#define __HOST_MBED_H__
+
+// The few mbed OS pieces the pure logic under src/ uses, for host builds
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace mbed {
+    template <typename F>
+    class Callback;
+
+    /**
+     * Same calls and comparison as mbed's Callback: a function pointer, an
+     * object and method, or a small trivially copyable function object.
+     */
+    template <typename R, typename... Args>
+    class Callback<R(Args...)>
+    {
+    public:
+        Callback() : _thunk(nullptr), _storage() {};
+        Callback(std::nullptr_t) : Callback() {};
+
+        Callback(R (*func)(Args...)) : Callback()
+        {
+            if (func)
+            {
+                store(func);
+            }
+        };
+
+        template <typename T, typename U>
+        Callback(U *obj, R (T::*method)(Args...)) : Callback()
+        {
+            store(Bound<U, R (T::*)(Args...)>{obj, method});
+        };
+
+        template <typename T, typename U>
+        Callback(const U *obj, R (T::*method)(Args...) const) : Callback()
+        {
+            store(Bound<const U, R (T::*)(Args...) const>{obj, method});
+        };
+
+        template <typename F, typename = typename std::enable_if<
+            std::is_class<typename std::decay<F>::type>::value &&
+            !std::is_same<typename std::decay<F>::type, Callback>::value>::type>
+        Callback(F func) : Callback()
+        {
+            store(func);
+        };
+
+        R operator()(Args... args) const { return _thunk(_storage, args...); };
+        explicit operator bool() const { return _thunk != nullptr; };
+
+        friend bool operator==(const Callback &a, const Callback &b)
+        {
+            return a._thunk == b._thunk && memcmp(a._storage, b._storage, sizeof(a._storage)) == 0;
+        };
+        friend bool operator!=(const Callback &a, const Callback &b) { return !(a == b); };
+
+    private:
+        template <typename U, typename M>
+        struct Bound
+        {
+            U *obj;
+            M method;
+            R operator()(Args... args) const { return (obj->*method)(args...); };
+        };
+
+        template <typename F>
+        void store(const F &func)
+        {
+            static_assert(sizeof(F) <= sizeof(_storage), "callback too big");
+            static_assert(std::is_trivially_copyable<F>::value, "callback must be trivially copyable");
+            memset(_storage, 0, sizeof(_storage));
+            new (_storage) F(func);
+            _thunk = &invoke<F>;
+        };
+
+        template <typename F>
+        static R invoke(const void *storage, Args... args)
+        {
+            return (*(F *)storage)(args...);
+        };
+
+        R (*_thunk)(const void *, Args...);
+        alignas(void *) unsigned char _storage[32];
+    };
+
+    template <typename R, typename... Args>
+    Callback<R(Args...)> callback(R (*func)(Args...))
+    {
+        return Callback<R(Args...)>(func);
+    }
+
+    template <typename T, typename U, typename R, typename... Args>
+    Callback<R(Args...)> callback(U *obj, R (T::*method)(Args...))
+    {
+        return Callback<R(Args...)>(obj, method);
+    }
+}
+
+using mbed::Callback;
+using mbed::callback;
+
+/**
+ * Interrupts are threads on the host, one lock stands in for masking them.
+ */
+class CriticalSectionLock
+{
+public:
+    CriticalSectionLock() { mutex().lock(); };
+    ~CriticalSectionLock() { mutex().unlock(); };
+
+private:
+    static std::recursive_mutex& mutex()
+    {
+        static std::recursive_mutex m;
+        return m;
+    };
+};
+
+inline uint32_t core_util_atomic_load_u32(const volatile uint32_t *p)
+{
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+inline void core_util_atomic_store_u32(volatile uint32_t *p, uint32_t v)
+{
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+inline bool core_util_atomic_cas_u32(volatile uint32_t *p, uint32_t *expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(p, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+inline uint32_t core_util_atomic_incr_u32(volatile uint32_t *p, uint32_t delta)
+{
+    return __atomic_add_fetch(p, delta, __ATOMIC_SEQ_CST);
+}
+
+inline uint32_t core_util_atomic_fetch_or_u32(volatile uint32_t *p, uint32_t v)
+{
+    return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST);
+}
+
+inline uint32_t core_util_atomic_exchange_u32(volatile uint32_t *p, uint32_t v)
+{
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+inline void core_util_atomic_store_ptr(void *volatile *p, void *v)
+{
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+inline void *core_util_atomic_exchange_ptr(void *volatile *p, void *v)
+{
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Microseconds since some point, wraps like the target's 32 bit ticker.
+ */
+inline uint32_t us_ticker_read()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+// Simulated kernel clock in ms, only moved by the tests and EventQueue::dispatch()
+extern uint64_t host_kernel_ms;
+
+namespace rtos {
+    namespace Kernel {
+        inline uint64_t get_ms_count()
+        {
+            return host_kernel_ms;
+        }
+    }
+}
+
+typedef enum {
+    osPriorityNormal = 24,
+} osPriority;
+
+typedef int32_t osStatus;
+#define osOK 0
+#define OS_STACK_SIZE 4096
+
+namespace rtos {
+    /**
+     * A thread that is never scheduled, the tests run the queues it would
+     * dispatch themselves. Without stack memory start() allocates the stack
+     * like mbed's Thread, so the heap counts match the target.
+     */
+    class Thread
+    {
+    public:
+        Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE,
+            unsigned char *stack_mem = nullptr, const char *name = nullptr) :
+            _stack_size(stack_size), _stack_mem(stack_mem), _own_stack(false), _name(name) {};
+
+        ~Thread()
+        {
+            if (_own_stack) {
+                delete[] _stack_mem;
+            }
+        };
+
+        osStatus start(mbed::Callback<void()> task)
+        {
+            if (_stack_mem == nullptr) {
+                _stack_mem = new unsigned char[_stack_size];
+                _own_stack = true;
+            }
+            _task = task;
+            return osOK;
+        };
+
+        osStatus join() { return osOK; };
+
+        const char *get_name() const { return _name; };
+
+        // The task start() was given, for a test to run in its place
+        const mbed::Callback<void()>& task() const { return _task; };
+
+    private:
+        Thread(const Thread &);
+        Thread& operator=(const Thread &);
+
+        uint32_t _stack_size;
+        unsigned char *_stack_mem;
+        bool _own_stack;
+        const char *_name;
+        mbed::Callback<void()> _task;
+    };
+}
+
+using rtos::Thread;
+
+#endif /* __HOST_MBED_H__ */
@@ -0,0 +1,34 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_NON_COPYABLE_H__
+#define __HOST_NON_COPYABLE_H__
+
+namespace mbed {
+    template <typename T>
+    class NonCopyable
+    {
+    protected:
+        NonCopyable() = default;
+        ~NonCopyable() = default;
+
+    public:
+        NonCopyable(const NonCopyable &) = delete;
+        NonCopyable& operator=(const NonCopyable &) = delete;
+    };
+}
+
+#endif /* __HOST_NON_COPYABLE_H__ */
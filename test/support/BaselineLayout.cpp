@@ -0,0 +1,92 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BaselineLayout.h"
+
+using Mytime::Windows::ChordTable;
+
+static std::vector<std::string> explode(const std::string &s, char c)
+{
+    std::string buff;
+    std::vector<std::string> v;
+
+    for (char n : s) {
+        if (n != c) {
+            buff += n;
+        } else if (!buff.empty()) {
+            v.push_back(buff);
+            buff.clear();
+        }
+    }
+    if (!buff.empty()) {
+        v.push_back(buff);
+    }
+    return v;
+}
+
+// _lv_txt_get_width() of one line, every glyph looked up in the font
+static int16_t line_width(const std::string &line, const lv_font_t *font, lv_coord_t letter_space)
+{
+    const char *txt = line.c_str();
+    uint32_t len = line.size();
+    uint32_t i = 0;
+    int32_t width = 0;
+
+    while (i < len) {
+        uint32_t letter = _lv_txt_encoded_next(txt, &i);
+        uint32_t next = i;
+        uint32_t letter_next = (i < len) ? _lv_txt_encoded_next(txt, &next) : 0;
+        int32_t glyph = lv_font_get_glyph_width(font, letter, letter_next);
+        if (glyph > 0) {
+            width += glyph + letter_space;
+        }
+    }
+    return (width > 0) ? width - letter_space : 0;
+}
+
+static BaselineLine allowable_words(const std::vector<std::string> &words, const lv_font_t *font,
+    lv_coord_t letter_space, int16_t max_width)
+{
+    std::string test_line;
+    std::string spacer;
+    BaselineLine fitted = {0, 0, ""};
+
+    for (size_t i = 0; i < words.size(); i++) {
+        test_line += spacer + words[i];
+        spacer = " ";
+
+        int16_t width = line_width(test_line, font, letter_space);
+        if (width > max_width) {
+            return fitted;
+        }
+        fitted = {(int16_t)(i + 1), width, test_line};
+    }
+    return fitted;
+}
+
+std::vector<BaselineLine> baseline_wrap(const char *text, const lv_font_t *font, lv_coord_t letter_space,
+    const ChordTable &lines)
+{
+    std::vector<std::string> words{explode(std::string(text), ' ')};
+    std::vector<BaselineLine> result;
+
+    for (const Lines *line = lines.begin(); line != lines.end() && !words.empty(); line++) {
+        BaselineLine line_data = allowable_words(words, font, letter_space, line->max_length);
+        words.erase(words.begin(), words.begin() + line_data.count);
+        result.push_back(line_data);
+    }
+    return result;
+}
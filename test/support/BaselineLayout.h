@@ -0,0 +1,46 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BASELINE_LAYOUT_H__
+#define __BASELINE_LAYOUT_H__
+
+#include "ChordTable.h"
+
+#include <lvgl/lvgl.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * The word wrap TextLayout replaced, wrapText() and calcAllowableWords() of
+ * the old Window.h without the labels, to compare against.
+ *
+ * The text is split into a vector of strings and every line is built up a
+ * word at a time, measuring the whole line again after each word the way
+ * _lv_txt_get_size() does. A word wider than a line is never placed, so the
+ * lines after it stay empty.
+ */
+struct BaselineLine
+{
+    int16_t count;
+    int16_t width;
+    std::string text;
+};
+
+std::vector<BaselineLine> baseline_wrap(const char *text, const lv_font_t *font, lv_coord_t letter_space,
+    const Mytime::Windows::ChordTable &lines);
+
+#endif /* __BASELINE_LAYOUT_H__ */
@@ -0,0 +1,86 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HeapCounter.h"
+
+#include <stdlib.h>
+#include <new>
+
+static volatile uint32_t allocs = 0;
+
+extern "C" {
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t n, size_t size);
+    void *__real_realloc(void *p, size_t size);
+
+    void *__wrap_malloc(size_t size)
+    {
+        allocs++;
+        return __real_malloc(size);
+    }
+
+    void *__wrap_calloc(size_t n, size_t size)
+    {
+        allocs++;
+        return __real_calloc(n, size);
+    }
+
+    void *__wrap_realloc(void *p, size_t size)
+    {
+        allocs++;
+        return __real_realloc(p, size);
+    }
+}
+
+// libstdc++ allocates through its own copy of malloc, count new here instead
+void *operator new(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+uint32_t heap_allocs()
+{
+    return allocs;
+}
@@ -0,0 +1,30 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HEAP_COUNTER_H__
+#define __HEAP_COUNTER_H__
+
+#include <stdint.h>
+
+/**
+ * malloc, calloc, realloc and operator new calls made by the test so far.
+ *
+ * Needs the test linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,
+ * see host_test_heap() in CMakeLists.txt.
+ */
+uint32_t heap_allocs();
+
+#endif /* __HEAP_COUNTER_H__ */
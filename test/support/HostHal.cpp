@@ -0,0 +1,131 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "common.h"
+#include "HostHal.h"
+#include "PanelMonitor.h"
+
+using namespace Mytime::Controllers;
+
+static PanelEmulator panel;
+static int cmd_data = 0;
+static int spi_freq = 0;
+static bool hold_transfers = false;
+static void (*transfer_done)(void) = NULL;
+
+PanelEmulator& host_panel()
+{
+    return panel;
+}
+
+void host_hal_reset()
+{
+    panel.reset();
+    PanelMonitor::reset();
+    cmd_data = 0;
+    spi_freq = 0;
+    hold_transfers = false;
+    transfer_done = NULL;
+}
+
+int host_spi_freq()
+{
+    return spi_freq;
+}
+
+void host_hal_hold_transfers(bool hold)
+{
+    hold_transfers = hold;
+}
+
+bool host_hal_complete()
+{
+    void (*done)(void) = transfer_done;
+    if (!done) {
+        return false;
+    }
+
+    transfer_done = NULL;
+    done();
+    return true;
+}
+
+void pin_rst_set(int val)
+{
+    if (!val) {
+        panel.reset();
+    }
+}
+
+void pin_cmd_set(int val)
+{
+    cmd_data = val;
+}
+
+void spi_cs_set(int val)
+{
+}
+
+void spi_wr(int data)
+{
+    uint8_t byte = data;
+    if (cmd_data) {
+        PanelMonitor::data(&byte, 1);
+        panel.data(&byte, 1);
+    } else {
+        PanelMonitor::command(byte);
+        panel.command(byte);
+    }
+}
+
+void spi_wr_mem(char *addr, int len)
+{
+    PanelMonitor::data((const uint8_t *)addr, len);
+    panel.data((const uint8_t *)addr, len);
+}
+
+void spi_wr_mem_async(char *addr, int len, void (*done)(void))
+{
+    // One transfer at a time, as with the single EasyDMA channel
+    if (transfer_done) {
+        printf("HostHal: transfer started while one is in progress\n");
+        abort();
+    }
+
+    spi_wr_mem(addr, len);
+    transfer_done = done;
+    if (!hold_transfers) {
+        host_hal_complete();
+    }
+}
+
+void spi_set_freq(int val)
+{
+    spi_freq = val;
+}
+
+void spi_mode(int bits, int mode)
+{
+}
+
+void delay_ms(int)
+{
+}
+
+void delay_us(int)
+{
+}
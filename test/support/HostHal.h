@@ -0,0 +1,58 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_HAL_H__
+#define __HOST_HAL_H__
+
+#include "PanelEmulator.h"
+
+/**
+ * Host build of the display HAL in common.h.
+ *
+ * Every byte written goes to PanelMonitor, which counts it the same way as
+ * on the watch, and to a PanelEmulator holding the frame. D/C comes from
+ * pin_cmd_set() as on the 8 bit bus.
+ *
+ * A background transfer completes inside spi_wr_mem_async() unless transfers
+ * are held, then the test completes them one by one, like the EasyDMA
+ * interrupt would.
+ */
+PanelEmulator& host_panel();
+
+/**
+ * Reset the panel, the monitor counters and the bus settings.
+ */
+void host_hal_reset();
+
+/**
+ * Last frequency set by spi_set_freq(), in Hz.
+ */
+int host_spi_freq();
+
+/**
+ * Hold background transfers until host_hal_complete() instead of finishing
+ * them straight away.
+ */
+void host_hal_hold_transfers(bool hold);
+
+/**
+ * Finish the held background transfer, if any.
+ *
+ * @return false if no transfer was in progress.
+ */
+bool host_hal_complete();
+
+#endif /* __HOST_HAL_H__ */
@@ -0,0 +1,71 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_LVGL_SCREEN_H__
+#define __HOST_LVGL_SCREEN_H__
+
+#include <lvgl/lvgl.h>
+
+/**
+ * What lv_refr_now() draws on the host, in place of LVGL's objects.
+ *
+ * Layers are painted in order from the screen up. A solid layer is filled
+ * like lv_draw_rect() does, through gpu_fill_cb when the driver has one and
+ * the fill is over 240 px, by LVGL's pixel loop otherwise. A layer with a
+ * pattern is drawn pixel by pixel, like an image. Colours are plain RGB565,
+ * the draw buffer holds them byte swapped as with LV_COLOR_16_SWAP.
+ *
+ * The refresh itself follows lvgl v7: invalidated areas are joined, each
+ * is drawn in strips as high as the draw buffer allows, after asking the
+ * rounder about a one column probe area, and every strip is handed to
+ * flush_cb. One buffer waits for its flush before the next strip is drawn,
+ * two take turns.
+ */
+struct HostLayer
+{
+    lv_area_t area;
+    uint16_t color;
+    uint16_t (*pattern)(lv_coord_t x, lv_coord_t y);
+};
+
+struct HostRefrStats
+{
+    uint32_t refreshes;     // refresh task runs with something to draw
+    uint32_t areas;         // areas drawn after joining
+    uint32_t strips;        // flush_cb calls
+    lv_coord_t max_rows;    // highest strip
+    uint32_t pattern_px;    // pixels drawn from patterns
+    uint32_t software_px;   // pixels filled by the pixel loop
+    uint32_t gpu_px;        // pixels filled through gpu_fill_cb
+    uint64_t fill_ns;       // host time spent on solid fills, either way
+};
+
+/**
+ * Forget the display, the screen and the counts.
+ */
+void host_lvgl_reset();
+
+/**
+ * Draw these layers from now on. The array is not copied.
+ */
+void host_screen_set(const HostLayer *layers, uint8_t count);
+
+const HostRefrStats& host_refr_stats();
+
+// Refresh task runs, drawn or not
+extern uint32_t host_refr_runs;
+
+#endif /* __HOST_LVGL_SCREEN_H__ */
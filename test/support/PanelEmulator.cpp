@@ -0,0 +1,249 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PanelEmulator.h"
+
+#include <stdio.h>
+#include <string.h>
+
+constexpr uint16_t PanelEmulator::Width;
+constexpr uint16_t PanelEmulator::Height;
+
+void PanelEmulator::reset()
+{
+    memset(_memory, 0, sizeof(_memory));
+    clear_stats();
+
+    _cmd = 0;
+    _param_index = 0;
+    _x1 = 0;
+    _x2 = Width - 1;
+    _y1 = 0;
+    _y2 = Height - 1;
+    _col = 0;
+    _row = 0;
+    _written = 0;
+    _pixel_index = 0;
+
+    _madctl = 0;
+    _colmod = 0x66;
+    _awake = false;
+    _display_on = false;
+
+    _scroll_top = 0;
+    _scroll_height = Height;
+    _scroll_start = 0;
+}
+
+void PanelEmulator::clear_stats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void PanelEmulator::command(uint8_t cmd)
+{
+    _stats.commands++;
+    _cmd = cmd;
+    _param_index = 0;
+    _pixel_index = 0;
+
+    switch (cmd) {
+        case SleepIn:
+            _awake = false;
+            break;
+        case SleepOut:
+            _awake = true;
+            break;
+        case DisplayOff:
+            _display_on = false;
+            break;
+        case DisplayOn:
+            _display_on = true;
+            break;
+        case MemoryWrite:
+            // RAMWR starts at the top left of the window, RAMWRC carries on
+            _col = _x1;
+            _row = _y1;
+            _written = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+void PanelEmulator::data(const uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (_cmd == MemoryWrite || _cmd == MemoryWriteContinue) {
+            pixel_byte(buf[i]);
+        } else {
+            parameter(buf[i]);
+        }
+    }
+}
+
+void PanelEmulator::parameter(uint8_t value)
+{
+    if (_param_index < sizeof(_params)) {
+        _params[_param_index] = value;
+    }
+    _param_index++;
+
+    switch (_cmd) {
+        case ColumnAddressSet:
+            if (_param_index == 4) {
+                _x1 = (_params[0] << 8) | _params[1];
+                _x2 = (_params[2] << 8) | _params[3];
+            }
+            break;
+        case RowAddressSet:
+            if (_param_index == 4) {
+                _y1 = (_params[0] << 8) | _params[1];
+                _y2 = (_params[2] << 8) | _params[3];
+            }
+            break;
+        case MemoryAccessControl:
+            _madctl = value;
+            break;
+        case PixelFormatSet:
+            _colmod = value;
+            break;
+        case VerticalScrollDefinition:
+            if (_param_index == 6) {
+                _scroll_top = (_params[0] << 8) | _params[1];
+                _scroll_height = (_params[2] << 8) | _params[3];
+            }
+            break;
+        case VerticalScrollStart:
+            if (_param_index == 2) {
+                _scroll_start = (_params[0] << 8) | _params[1];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void PanelEmulator::pixel_byte(uint8_t value)
+{
+    _pixel[_pixel_index++] = value;
+
+    if ((_colmod & 0x07) == 0x05) {
+        // 16 bit, high byte first
+        if (_pixel_index == 2) {
+            store((_pixel[0] << 8) | _pixel[1]);
+            _pixel_index = 0;
+        }
+    } else if (_pixel_index == 3) {
+        // 18 bit, 6 bits of each colour at the top of a byte
+        store(((_pixel[0] >> 3) << 11) | ((_pixel[1] >> 2) << 5) | (_pixel[2] >> 3));
+        _pixel_index = 0;
+    }
+}
+
+void PanelEmulator::store(uint16_t color)
+{
+    uint16_t x = _col;
+    uint16_t y = _row;
+
+    if (_madctl & MX) {
+        x = Width - 1 - x;
+    }
+    if (_madctl & MY) {
+        y = Height - 1 - y;
+    }
+    if (_madctl & MV) {
+        uint16_t t = x;
+        x = y;
+        y = t;
+    }
+
+    if (x < Width && y < Height) {
+        _memory[y][x] = color;
+        _stats.pixels++;
+        if (!visible(x, y)) {
+            _stats.hidden_pixels++;
+        }
+    }
+
+    // Columns first, then rows, back to the start after the last pixel
+    if (_col < _x2) {
+        _col++;
+    } else {
+        _col = _x1;
+        if (_row < _y2) {
+            _row++;
+        } else {
+            _row = _y1;
+        }
+    }
+
+    _written++;
+    if (_written > (uint32_t)(_x2 - _x1 + 1) * (_y2 - _y1 + 1)) {
+        _stats.overruns++;
+    }
+}
+
+uint16_t PanelEmulator::shown(uint16_t x, uint16_t y) const
+{
+    if (!_awake || !_display_on) {
+        return 0;
+    }
+
+    // Rows of the scroll area show memory from the scroll start on
+    uint16_t row = y;
+    if (y >= _scroll_top && y < _scroll_top + _scroll_height && _scroll_height) {
+        row = _scroll_top + (y - _scroll_top + _scroll_start - _scroll_top + _scroll_height) % _scroll_height;
+    }
+
+    uint16_t color = _memory[row][x];
+    if (_madctl & BGR) {
+        color = (uint16_t)(((color & 0x1F) << 11) | (color & 0x07E0) | (color >> 11));
+    }
+    return color;
+}
+
+bool PanelEmulator::visible(uint16_t x, uint16_t y)
+{
+    // Pixel centre inside the circle, as RoundPanel works it out
+    int32_t dx = 2 * x + 1 - Width;
+    int32_t dy = 2 * y + 1 - Height;
+    return dx * dx + dy * dy <= Width * Width;
+}
+
+bool PanelEmulator::write_ppm(const char *path) const
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+
+    fprintf(f, "P6\n%d %d\n255\n", Width, Height);
+    for (uint16_t y = 0; y < Height; y++) {
+        for (uint16_t x = 0; x < Width; x++) {
+            uint8_t rgb[3] = {0x40, 0x40, 0x40};
+            if (visible(x, y)) {
+                uint16_t c = shown(x, y);
+                rgb[0] = (uint8_t)(((c >> 11) & 0x1F) * 255 / 31);
+                rgb[1] = (uint8_t)(((c >> 5) & 0x3F) * 255 / 63);
+                rgb[2] = (uint8_t)((c & 0x1F) * 255 / 31);
+            }
+            fwrite(rgb, 1, sizeof(rgb), f);
+        }
+    }
+
+    return fclose(f) == 0;
+}
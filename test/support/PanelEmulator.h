@@ -0,0 +1,146 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PANEL_EMULATOR_H__
+#define __PANEL_EMULATOR_H__
+
+#include <stdint.h>
+
+/**
+ * A GC9A01 on the host: the command stream goes into display memory.
+ *
+ * Follows SLPIN/SLPOUT, DISPOFF/DISPON, CASET/RASET/RAMWR/RAMWRC, MADCTL,
+ * COLMOD, VSCRDEF and VSCSAD. Memory writes walk the window a row at a
+ * time and wrap back to its start when they run past the end, like the
+ * panel. MADCTL MY and MX mirror rows and columns before MV exchanges
+ * them, the BGR bit swaps red and blue when the frame is read.
+ *
+ * What the glass shows, scroll applied, can be read back a pixel at a time
+ * or written out as a PPM image.
+ */
+class PanelEmulator
+{
+public:
+    static constexpr uint16_t Width = 240;
+    static constexpr uint16_t Height = 240;
+
+    struct Stats {
+        uint32_t commands;
+        uint32_t pixels;            // pixels written to display memory
+        uint32_t hidden_pixels;     // of those, behind the round bezel
+        uint32_t overruns;          // pixels written past the end of the window
+    };
+
+    PanelEmulator() { reset(); };
+
+    /**
+     * Back to the state after a hardware reset, memory cleared to black.
+     */
+    void reset();
+
+    /**
+     * A byte sent with D/C low.
+     */
+    void command(uint8_t cmd);
+
+    /**
+     * Bytes sent with D/C high.
+     */
+    void data(const uint8_t *buf, uint32_t len);
+
+    /**
+     * Display memory at a panel position, as RGB565.
+     */
+    uint16_t memory(uint16_t x, uint16_t y) const { return _memory[y][x]; };
+
+    /**
+     * What the glass shows at a position, as RGB565 in RGB order.
+     *
+     * Black while asleep or switched off.
+     */
+    uint16_t shown(uint16_t x, uint16_t y) const;
+
+    /**
+     * Whether a panel position is visible through the round glass.
+     */
+    static bool visible(uint16_t x, uint16_t y);
+
+    /**
+     * Write what the glass shows as a binary PPM, hidden corners in grey.
+     *
+     * @return false if the file could not be written.
+     */
+    bool write_ppm(const char *path) const;
+
+    const Stats& stats() const { return _stats; };
+    void clear_stats();
+
+    bool awake() const { return _awake; };
+    bool display_on() const { return _display_on; };
+    uint8_t madctl() const { return _madctl; };
+    uint16_t scroll_start() const { return _scroll_start; };
+
+private:
+    enum Commands : uint8_t {
+        SleepIn = 0x10,
+        SleepOut = 0x11,
+        DisplayOff = 0x28,
+        DisplayOn = 0x29,
+        ColumnAddressSet = 0x2A,
+        RowAddressSet = 0x2B,
+        MemoryWrite = 0x2C,
+        VerticalScrollDefinition = 0x33,
+        MemoryAccessControl = 0x36,
+        VerticalScrollStart = 0x37,
+        PixelFormatSet = 0x3A,
+        MemoryWriteContinue = 0x3C
+    };
+
+    enum Madctl : uint8_t {
+        MY = 0x80,
+        MX = 0x40,
+        MV = 0x20,
+        BGR = 0x08
+    };
+
+    void parameter(uint8_t value);
+    void pixel_byte(uint8_t value);
+    void store(uint16_t color);
+
+    uint16_t _memory[Height][Width];
+    Stats _stats;
+
+    uint8_t _cmd;
+    uint8_t _params[6];
+    uint8_t _param_index;
+
+    uint16_t _x1, _x2, _y1, _y2;
+    uint16_t _col, _row;
+    uint32_t _written;
+    uint8_t _pixel[3];
+    uint8_t _pixel_index;
+
+    uint8_t _madctl;
+    uint8_t _colmod;
+    bool _awake;
+    bool _display_on;
+
+    uint16_t _scroll_top;
+    uint16_t _scroll_height;
+    uint16_t _scroll_start;
+};
+
+#endif /* __PANEL_EMULATOR_H__ */
@@ -0,0 +1,78 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestFonts.h"
+
+struct Advances
+{
+    uint16_t adv_w[0x7F - 0x20];
+
+    Advances(uint16_t scale)
+    {
+        for (uint32_t c = 0x20; c < 0x7F; c++) {
+            uint16_t adv;
+            if (c == ' ') {
+                adv = 72;
+            } else if (strchr("ijl.,'!", c)) {
+                adv = 68;
+            } else if (strchr("mwMW", c)) {
+                adv = 216;
+            } else if (c >= 'A' && c <= 'Z') {
+                adv = 168;
+            } else if (c >= 'a' && c <= 'z') {
+                adv = 132;
+            } else if (c >= '0' && c <= '9') {
+                adv = 140;
+            } else {
+                adv = 120;
+            }
+            adv_w[c - 0x20] = adv * scale;
+        }
+    };
+};
+
+static const Advances advances(1);
+static const Advances advances_large(2);
+static const Advances advances_wide(20);
+
+static const char kern_pairs[] = "AVVAToWar.y,W  WT\xE9";
+static const int8_t kern_values[] = {-24, -24, -20, -16, -12, -12, -8, -8, -20};
+
+static const lv_font_fmt_txt_dsc_t kerned_dsc = {
+    kern_pairs, 16, advances.adv_w, 132, kern_pairs, kern_values, sizeof(kern_values)
+};
+static const lv_font_fmt_txt_dsc_t plain_dsc = {
+    NULL, 16, advances.adv_w, 132, NULL, NULL, 0
+};
+static const lv_font_fmt_txt_dsc_t large_dsc = {
+    kern_pairs, 16, advances_large.adv_w, 132 * 2, kern_pairs, kern_values, sizeof(kern_values)
+};
+static const lv_font_fmt_txt_dsc_t wide_dsc = {
+    NULL, 16, advances_wide.adv_w, 132 * 20, NULL, NULL, 0
+};
+
+const lv_font_t test_font_kerned = {
+    lv_font_get_glyph_dsc_fmt_txt, NULL, 16, 3, 0, -2, 1, (void *)&kerned_dsc, NULL
+};
+const lv_font_t test_font_plain = {
+    lv_font_get_glyph_dsc_fmt_txt, NULL, 16, 3, 0, -2, 1, (void *)&plain_dsc, NULL
+};
+const lv_font_t test_font_large = {
+    lv_font_get_glyph_dsc_fmt_txt, NULL, 36, 7, 0, -4, 1, (void *)&large_dsc, NULL
+};
+const lv_font_t test_font_wide = {
+    lv_font_get_glyph_dsc_fmt_txt, NULL, 20, 4, 0, -2, 1, (void *)&wide_dsc, NULL
+};
@@ -0,0 +1,41 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017-2019 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEST_FONTS_H__
+#define __TEST_FONTS_H__
+
+#include <lvgl/lvgl.h>
+
+/**
+ * Fonts in lvgl's built in format with made up, uneven advances.
+ *
+ * Advances are in 1/16 px and rounded by the font like lvgl does, so kerning
+ * can move a glyph by a pixel or not at all.
+ */
+
+// 16 px line, kerning pairs AV VA To Wa r. y, "W " " W" and T followed by e acute
+extern const lv_font_t test_font_kerned;
+// Same advances without a kerning table
+extern const lv_font_t test_font_plain;
+// Twice as wide with the same kerning on a 36 px line, a headline font
+extern const lv_font_t test_font_large;
+// Everything 20 times wider, m w M W are too wide for the uint8 advance table
+extern const lv_font_t test_font_wide;
+
+// Glyph descriptions asked of any font, counted by the lvgl stub
+extern uint32_t host_glyph_lookups;
+
+#endif /* __TEST_FONTS_H__ */